@@ -0,0 +1,268 @@
+#ifndef LOTKEY_CPP_JUCE_BASICOSCILLATOR_H
+#define LOTKEY_CPP_JUCE_BASICOSCILLATOR_H
+
+#include <cmath>
+#include "Oscillators.h"
+#include "Interpolation.h"
+#include "Simd.h"
+
+/// <summary>
+/// Shape policies for BasicOscillator.
+/// Each policy maps Simd::width phases in [0, 1) to samples and is inlined into the render loop.
+/// </summary>
+namespace Oscillators::Shapes {
+	struct Saw {
+		template <typename Interp>
+		Simd::Float evaluate(const Simd::Float& phase) const { return Simd::saw(phase); }
+	};
+
+	struct Square {
+		template <typename Interp>
+		Simd::Float evaluate(const Simd::Float& phase) const { return Simd::square(phase); }
+	};
+
+	struct Triangle {
+		template <typename Interp>
+		Simd::Float evaluate(const Simd::Float& phase) const { return Simd::triangle(phase); }
+	};
+
+	/// <summary>
+	/// Polynomial sine, see Simd::sine for its accuracy
+	/// </summary>
+	struct Sine {
+		template <typename Interp>
+		Simd::Float evaluate(const Simd::Float& phase) const { return Simd::sine(phase); }
+	};
+
+	/// <summary>
+	/// Shared wavetable read through the Interp policy
+	/// </summary>
+	struct Table {
+		Oscillators::Wavetables::Table table = Oscillators::Wavetables::getSharedWavetable(Oscillators::Type::SINE, WAVETABLE_SIZE);
+
+		template <typename Interp>
+		Simd::Float evaluate(const Simd::Float& phase) const {
+			return Interp::read(table.samples.get(), table.size, Simd::mul(phase, Simd::set((float)table.size)));
+		}
+	};
+};
+
+/// <summary>
+/// Oscillator with the shape and interpolation chosen at compile time.
+/// The shape kernel is inlined into the block loop, so there is no virtual call
+/// and the loop renders Simd::width samples per iteration.
+/// Use OscillatorAdapter to pass one where an Oscillator* is expected.
+/// </summary>
+template <typename Shape, typename Interp = Oscillators::Interpolation::Linear>
+class Oscillators::BasicOscillator {
+private:
+	Shape shape;
+	float sampleRate = 48000;
+	double phase = 0.0;
+public:
+	/// <summary>
+	/// Default constructor
+	/// </summary>
+	BasicOscillator() {}
+	/// <summary>
+	/// Constructor from sample rate
+	/// </summary>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	BasicOscillator(const float& sampleRate) : sampleRate(sampleRate) {}
+	/// <summary>
+	/// Set the sample rate of the oscillator
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) { this->sampleRate = sampleRate; }
+	/// <summary>
+	/// Restart the phase
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) { phase = cycles - std::floor(cycles); }
+	/// <summary>
+	/// Access the shape policy, e.g. to change the table of Shapes::Table
+	/// </summary>
+	Shape& getShape() { return shape; }
+	/// <summary>
+	/// Write the next block with the oscillator
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlock(const float& frequency, const unsigned& blockSize, float* block) {
+		const double delta = (double)frequency / sampleRate;
+
+		float ramp[Simd::width];
+		for (unsigned i = 0; i < Simd::width; i++) {
+			ramp[i] = (float)(i * delta);
+		}
+		const Simd::Float offsets = Simd::load(ramp);
+
+		unsigned i = 0;
+		for (; i + Simd::width <= blockSize; i += Simd::width) {
+			Simd::Float phases = Simd::wrap(Simd::add(Simd::set((float)phase), offsets));
+			Simd::store(block + i, shape.template evaluate<Interp>(phases));
+			phase += Simd::width * delta;
+			phase -= std::floor(phase);
+		}
+		if (i < blockSize) {
+			float tail[Simd::width];
+			Simd::Float phases = Simd::wrap(Simd::add(Simd::set((float)phase), offsets));
+			Simd::store(tail, shape.template evaluate<Interp>(phases));
+			for (unsigned j = 0; i + j < blockSize; j++) {
+				block[i + j] = tail[j];
+			}
+			phase += (blockSize - i) * delta;
+			phase -= std::floor(phase);
+		}
+	}
+	/// <summary>
+	/// Write the next block with a pitch per sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample, |frequency| below sampleRate </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlock(const float* frequencies, const unsigned& blockSize, float* block) {
+		const double inverseSampleRate = 1.0 / sampleRate;
+		for (unsigned i = 0; i < blockSize; i++) {
+			block[i] = (float)phase;
+			phase += frequencies[i] * inverseSampleRate;
+			if (phase >= 1.0) {
+				phase -= 1.0;
+			}
+			else if (phase < 0.0) {
+				phase += 1.0;
+			}
+		}
+		Simd::transform(blockSize, block, [this](const Simd::Float& phases) {
+			return shape.template evaluate<Interp>(Simd::wrap(phases));
+		});
+	}
+	/// <summary>
+	/// Write the next block with the oscillator
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="amplitude"> - amplitude of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, float* block) {
+		writeBlock(frequency, blockSize, block);
+		for (unsigned i = 0; i < blockSize; i++) {
+			block[i] *= amplitude;
+		}
+	}
+	/// <summary>
+	/// Add the next block onto block instead of overwriting it.
+	/// The add is fused into the render loop, so block is read and written once.
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to add to </param>
+	/// <param name="gain"> - gain applied to the oscillator before adding </param>
+	/// <param name="block"> - float* to add to </param>
+	void addBlock(const float& frequency, const unsigned& blockSize, const float& gain, float* block) {
+		const double delta = (double)frequency / sampleRate;
+		const Simd::Float gains = Simd::set(gain);
+
+		float ramp[Simd::width];
+		for (unsigned i = 0; i < Simd::width; i++) {
+			ramp[i] = (float)(i * delta);
+		}
+		const Simd::Float offsets = Simd::load(ramp);
+
+		unsigned i = 0;
+		for (; i + Simd::width <= blockSize; i += Simd::width) {
+			Simd::Float phases = Simd::wrap(Simd::add(Simd::set((float)phase), offsets));
+			Simd::store(block + i, Simd::mulAdd(shape.template evaluate<Interp>(phases), gains, Simd::load(block + i)));
+			phase += Simd::width * delta;
+			phase -= std::floor(phase);
+		}
+		if (i < blockSize) {
+			float tail[Simd::width];
+			Simd::Float phases = Simd::wrap(Simd::add(Simd::set((float)phase), offsets));
+			Simd::store(tail, shape.template evaluate<Interp>(phases));
+			for (unsigned j = 0; i + j < blockSize; j++) {
+				block[i + j] += gain * tail[j];
+			}
+			phase += (blockSize - i) * delta;
+			phase -= std::floor(phase);
+		}
+	}
+	/// <summary>
+	/// Add the next block with a pitch per sample onto block instead of overwriting it
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample, |frequency| below sampleRate </param>
+	/// <param name="blockSize"> - size of the block to add to </param>
+	/// <param name="gain"> - gain applied to the oscillator before adding </param>
+	/// <param name="block"> - float* to add to </param>
+	void addBlock(const float* frequencies, const unsigned& blockSize, const float& gain, float* block) {
+		const double inverseSampleRate = 1.0 / sampleRate;
+		float lanes[Simd::width];
+		for (unsigned i = 0; i < blockSize; i += Simd::width) {
+			const unsigned count = (blockSize - i < Simd::width) ? blockSize - i : Simd::width;
+			for (unsigned j = 0; j < Simd::width; j++) {
+				lanes[j] = (float)phase;
+				if (j < count) {
+					phase += frequencies[i + j] * inverseSampleRate;
+					if (phase >= 1.0) {
+						phase -= 1.0;
+					}
+					else if (phase < 0.0) {
+						phase += 1.0;
+					}
+				}
+			}
+			Simd::store(lanes, shape.template evaluate<Interp>(Simd::wrap(Simd::load(lanes))));
+			for (unsigned j = 0; j < count; j++) {
+				block[i + j] += gain * lanes[j];
+			}
+		}
+	}
+};
+
+/// <summary>
+/// Exposes a BasicOscillator through the virtual Oscillator interface
+/// </summary>
+template <typename Shape, typename Interp = Oscillators::Interpolation::Linear>
+class Oscillators::OscillatorAdapter : public Oscillators::Oscillator {
+private:
+	Oscillators::BasicOscillator<Shape, Interp> oscillator;
+protected:
+	void render(const float& frequency, const unsigned& blockSize, float* block) override {
+		oscillator.writeBlock(frequency, blockSize, block);
+	}
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override {
+		oscillator.writeBlock(frequencies, blockSize, block);
+	}
+	void accumulate(const float& frequency, const unsigned& blockSize, const float& gain, float* block) override {
+		oscillator.addBlock(frequency, blockSize, gain, block);
+	}
+	void accumulate(const float* frequencies, const unsigned& blockSize, const float& gain, float* block) override {
+		oscillator.addBlock(frequencies, blockSize, gain, block);
+	}
+public:
+	/// <summary>
+	/// Default constructor
+	/// </summary>
+	OscillatorAdapter() {}
+	/// <summary>
+	/// Constructor from sample rate
+	/// </summary>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	OscillatorAdapter(const float& sampleRate) : oscillator(sampleRate) {}
+	/// <summary>
+	/// Set the sample rate of the oscillator
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) override { oscillator.setSampleRate(sampleRate); }
+	/// <summary>
+	/// Restart the phase
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override { oscillator.resetPhase(cycles); }
+	/// <summary>
+	/// Access the wrapped oscillator
+	/// </summary>
+	Oscillators::BasicOscillator<Shape, Interp>& getOscillator() { return oscillator; }
+};
+
+#endif
@@ -0,0 +1,616 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../Oscillators.h"
+#include "../Simd.h"
+
+namespace {
+	const float SAMPLE_RATE = 48000.0f;
+	const float FREQUENCY = 440.0f;
+	const unsigned BLOCK_SIZES[] = { 16, 64, 256, 1024, 4096 };
+
+	struct Result {
+		std::string oscillator;
+		std::string mode;
+		std::string path;
+		unsigned blockSize;
+		unsigned voices;
+		double nsPerSample;
+	};
+
+	double minSeconds = 0.05;
+	volatile float sink = 0.0f;
+
+	/// <summary>
+	/// Time a render callback and return the best ns per rendered sample (per voice)
+	/// </summary>
+	double measure(const unsigned& samplesPerCall, const std::function<void()>& render) {
+		using clock = std::chrono::steady_clock;
+		render();
+
+		double best = 1e300;
+		for (unsigned run = 0; run < 3; run++) {
+			unsigned long long samples = 0;
+			auto start = clock::now();
+			double elapsed = 0.0;
+			do {
+				render();
+				samples += samplesPerCall;
+				elapsed = std::chrono::duration<double>(clock::now() - start).count();
+			} while (elapsed < minSeconds / 3.0);
+
+			double ns = elapsed * 1e9 / (double)samples;
+			best = (ns < best) ? ns : best;
+		}
+		return best;
+	}
+
+	void benchmarkPaths(std::vector<Result>& results, const std::string& name, const std::string& mode, Oscillators::Oscillator& oscillator) {
+		for (unsigned blockSize : BLOCK_SIZES) {
+			std::vector<float> block(blockSize);
+			std::vector<float> frequencies(blockSize);
+			std::vector<float> amplitudes(blockSize, 0.5f);
+			for (unsigned i = 0; i < blockSize; i++) {
+				// Vibrato, so the per-sample paths cannot be folded into a fixed pitch
+				frequencies[i] = FREQUENCY * (1.0f + 0.01f * std::sin(0.01f * (float)i));
+			}
+			// A pitch and an amplitude change at each quarter of the block
+			std::vector<Oscillators::Oscillator::Event> events;
+			for (unsigned quarter = 0; quarter < 4; quarter++) {
+				const unsigned offset = quarter * blockSize / 4;
+				events.push_back({ offset, Oscillators::Oscillator::Event::Kind::FREQUENCY, FREQUENCY * (1.0f + 0.1f * (float)quarter) });
+				events.push_back({ offset, Oscillators::Oscillator::Event::Kind::AMPLITUDE, 0.5f });
+			}
+			oscillator.prepare(blockSize);
+
+			results.push_back({ name, mode, "getBlock", blockSize, 1, measure(blockSize, [&]() {
+				sink = oscillator.getBlock(FREQUENCY, blockSize)[0];
+			}) });
+			results.push_back({ name, mode, "getBlock+amplitude", blockSize, 1, measure(blockSize, [&]() {
+				sink = oscillator.getBlock(FREQUENCY, blockSize, 0.5f)[0];
+			}) });
+			results.push_back({ name, mode, "writeBlock", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.writeBlock(FREQUENCY, blockSize, block.data());
+				sink = block[0];
+			}) });
+			results.push_back({ name, mode, "writeBlock+amplitude", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.writeBlock(FREQUENCY, blockSize, 0.5f, block.data());
+				sink = block[0];
+			}) });
+			results.push_back({ name, mode, "writeBlock+frequencies", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.writeBlock(frequencies.data(), blockSize, block.data());
+				sink = block[0];
+			}) });
+			results.push_back({ name, mode, "writeBlock+frequencies+amplitudes", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.writeBlockAmplitudes(frequencies.data(), blockSize, amplitudes.data(), block.data());
+				sink = block[0];
+			}) });
+			results.push_back({ name, mode, "writeBlock+ramp", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.writeBlock(FREQUENCY, 2.0f * FREQUENCY, blockSize, 0.0f, 1.0f, block.data());
+				sink = block[0];
+			}) });
+			results.push_back({ name, mode, "addBlock", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.addBlock(FREQUENCY, blockSize, 1e-3f, block.data());
+				sink = block[0];
+			}) });
+			results.push_back({ name, mode, "writeBlock+events", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.writeBlock(events.data(), (unsigned)events.size(), blockSize, block.data());
+				sink = block[0];
+			}) });
+		}
+	}
+
+	template <typename Shape, typename Interp>
+	void benchmarkBasic(std::vector<Result>& results, const std::string& name, const std::string& mode) {
+		Oscillators::BasicOscillator<Shape, Interp> oscillator(SAMPLE_RATE);
+		for (unsigned blockSize : BLOCK_SIZES) {
+			std::vector<float> block(blockSize);
+			results.push_back({ name, mode, "writeBlock", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.writeBlock(FREQUENCY, blockSize, block.data());
+				sink = block[0];
+			}) });
+			results.push_back({ name, mode, "addBlock", blockSize, 1, measure(blockSize, [&]() {
+				oscillator.addBlock(FREQUENCY, blockSize, 1e-3f, block.data());
+				sink = block[0];
+			}) });
+		}
+	}
+
+	void benchmarkBank(std::vector<Result>& results, const std::string& name, const Oscillators::Type& type) {
+		for (unsigned voices : { 8u, 64u, 256u }) {
+			Oscillators::OscillatorBank bank(type, SAMPLE_RATE, voices);
+			for (unsigned voice = 0; voice < voices; voice++) {
+				bank.setVoice(voice, FREQUENCY * (1.0f + 0.01f * voice), 1.0f / voices);
+			}
+			for (unsigned blockSize : BLOCK_SIZES) {
+				std::vector<float> block(blockSize);
+				results.push_back({ name, "bank", "writeBlock", blockSize, voices, measure(blockSize * voices, [&]() {
+					bank.writeBlock(blockSize, block.data());
+					sink = block[0];
+				}) });
+				results.push_back({ name, "bank", "addBlock", blockSize, voices, measure(blockSize * voices, [&]() {
+					bank.addBlock(blockSize, 1e-3f, block.data());
+					sink = block[0];
+				}) });
+			}
+		}
+	}
+
+	/// <summary>
+	/// Detuned saw stacks against the same number of separate Saw oscillators.
+	/// nsPerSample is per stacked voice, so the three paths compare directly.
+	/// </summary>
+	void benchmarkUnison(std::vector<Result>& results, const std::string& name, const std::string& mode, const Oscillators::Antialiasing& antialiasing) {
+		for (unsigned voices : { 7u, 16u }) {
+			Oscillators::Unison unison(Oscillators::Type::SAW, SAMPLE_RATE, voices);
+			unison.setAntialiasing(antialiasing);
+			std::vector<Oscillators::Saw> saws(voices, Oscillators::Saw(SAMPLE_RATE, antialiasing));
+			for (unsigned blockSize : BLOCK_SIZES) {
+				std::vector<float> left(blockSize);
+				std::vector<float> right(blockSize);
+				results.push_back({ name, mode, "writeStereo", blockSize, voices, measure(blockSize * voices, [&]() {
+					unison.writeStereo(FREQUENCY, blockSize, left.data(), right.data());
+					sink = left[0];
+				}) });
+				results.push_back({ name, mode, "writeBlock", blockSize, voices, measure(blockSize * voices, [&]() {
+					unison.writeBlock(FREQUENCY, blockSize, left.data());
+					sink = left[0];
+				}) });
+				results.push_back({ name, mode + " separate Saw", "addBlock", blockSize, voices, measure(blockSize * voices, [&]() {
+					for (unsigned voice = 0; voice < voices; voice++) {
+						saws[voice].addBlock(FREQUENCY * (1.0f + 0.001f * voice), blockSize, 0.25f, left.data());
+					}
+					sink = left[0];
+				}) });
+			}
+		}
+	}
+
+	/// <summary>
+	/// Oversampled naive saws, decimated by the half-band cascade and, for comparison, by one
+	/// direct FIR with the same passband and rejection at the oversampled rate. The direct FIR
+	/// already only computes the outputs it keeps, so it is the cheaper form of the naive approach.
+	/// </summary>
+	void benchmarkOversampler(std::vector<Result>& results) {
+		for (unsigned factor : { 2u, 4u, 8u }) {
+			Oscillators::Saw saw;
+			Oscillators::Oversampler oversampler(saw, factor, SAMPLE_RATE);
+
+			// Windowed sinc passing 0.42 and stopping from 0.58 of the output rate: about 80 taps per 2x
+			const unsigned taps = 80 * factor / 2;
+			static_assert(80 % 16 == 0, "taps are summed two vectors at a time");
+			std::vector<float> coefficients(taps);
+			for (unsigned i = 0; i < taps; i++) {
+				double x = ((double)i - (taps - 1) / 2.0) / factor;
+				double window = 0.42 - 0.5 * std::cos(2.0 * PI * i / (taps - 1)) + 0.08 * std::cos(4.0 * PI * i / (taps - 1));
+				coefficients[i] = (float)(((x == 0.0) ? 1.0 : std::sin(PI * x) / (PI * x)) * window / factor);
+			}
+			Oscillators::Saw direct((float)(SAMPLE_RATE * factor));
+
+			const std::string mode = std::to_string(factor) + "x";
+			for (unsigned blockSize : BLOCK_SIZES) {
+				std::vector<float> block(blockSize);
+				std::vector<float> oversampled(blockSize * factor + taps, 0.0f);
+				results.push_back({ "Oversampler<Saw>", mode + " half-band", "writeBlock", blockSize, 1, measure(blockSize, [&]() {
+					oversampler.writeBlock(FREQUENCY, blockSize, block.data());
+					sink = block[0];
+				}) });
+				results.push_back({ "Oversampler<Saw>", mode + " direct FIR", "writeBlock", blockSize, 1, measure(blockSize, [&]() {
+					std::copy(oversampled.end() - taps, oversampled.end(), oversampled.begin());
+					direct.writeBlock(FREQUENCY, blockSize * factor, oversampled.data() + taps);
+					for (unsigned i = 0; i < blockSize; i++) {
+						const float* input = oversampled.data() + (size_t)i * factor + 1;
+						// Two vector accumulators and one horizontal sum per output
+						Oscillators::Simd::Float first = Oscillators::Simd::set(0.0f);
+						Oscillators::Simd::Float second = Oscillators::Simd::set(0.0f);
+						for (unsigned tap = 0; tap < taps; tap += 2 * Oscillators::Simd::width) {
+							const unsigned next = tap + Oscillators::Simd::width;
+							first = Oscillators::Simd::mulAdd(Oscillators::Simd::load(coefficients.data() + tap), Oscillators::Simd::load(input + tap), first);
+							second = Oscillators::Simd::mulAdd(Oscillators::Simd::load(coefficients.data() + next), Oscillators::Simd::load(input + next), second);
+						}
+						block[i] = Oscillators::Simd::sum(Oscillators::Simd::add(first, second));
+					}
+					sink = block[0];
+				}) });
+			}
+		}
+	}
+
+	/// <summary>
+	/// A DX-style algorithm: modulator to carrier connections, one operator fed back into
+	/// itself, and the carriers that are heard. Modulators have higher indices than what they modulate.
+	/// </summary>
+	struct Algorithm {
+		const char* name;
+		unsigned numOperators;
+		std::vector<std::pair<unsigned, unsigned>> connections;
+		unsigned feedback;
+		std::vector<unsigned> carriers;
+	};
+
+	/// <summary>
+	/// Common 4 and 6 operator algorithms rendered by the compiled graph and, for comparison,
+	/// by the straightforward form: one operator after another, one sample at a time, with std::sin
+	/// </summary>
+	void benchmarkOperatorGraph(std::vector<Result>& results) {
+		const float INDEX = 2.0f;
+		const float RATIOS[] = { 1.0f, 2.0f, 3.0f, 1.5f, 0.5f, 4.0f };
+		const Algorithm algorithms[] = {
+			{ "4-op stack", 4, { { 3, 2 }, { 2, 1 }, { 1, 0 } }, 3, { 0 } },
+			{ "4-op two pairs", 4, { { 1, 0 }, { 3, 2 } }, 3, { 0, 2 } },
+			{ "DX7 algorithm 1", 6, { { 1, 0 }, { 3, 2 }, { 4, 3 }, { 5, 4 } }, 5, { 0, 2 } },
+			{ "DX7 algorithm 5", 6, { { 1, 0 }, { 3, 2 }, { 5, 4 } }, 5, { 0, 2, 4 } },
+			{ "DX7 algorithm 32", 6, {}, 5, { 0, 1, 2, 3, 4, 5 } }
+		};
+
+		for (const Algorithm& algorithm : algorithms) {
+			Oscillators::OperatorGraph graph(algorithm.numOperators, SAMPLE_RATE);
+			for (unsigned op = 0; op < algorithm.numOperators; op++) {
+				graph.setRatio(op, RATIOS[op]);
+			}
+			for (const auto& connection : algorithm.connections) {
+				graph.setModulation(connection.first, connection.second, INDEX);
+			}
+			graph.setFeedback(algorithm.feedback, INDEX);
+			for (unsigned carrier : algorithm.carriers) {
+				graph.setLevel(carrier, 1.0f / (float)algorithm.carriers.size());
+			}
+
+			std::vector<double> phases(algorithm.numOperators, 0.0);
+			std::vector<float> outputs(algorithm.numOperators, 0.0f);
+			float last = 0.0f, beforeLast = 0.0f;
+			for (unsigned blockSize : BLOCK_SIZES) {
+				std::vector<float> block(blockSize);
+				results.push_back({ "OperatorGraph", algorithm.name, "writeBlock", blockSize, 1, measure(blockSize, [&]() {
+					graph.writeBlock(FREQUENCY, blockSize, block.data());
+					sink = block[0];
+				}) });
+				results.push_back({ "OperatorGraph", std::string(algorithm.name) + " per-sample", "writeBlock", blockSize, 1, measure(blockSize, [&]() {
+					for (unsigned i = 0; i < blockSize; i++) {
+						float sum = 0.0f;
+						for (unsigned op = algorithm.numOperators; op-- > 0;) {
+							double phase = 2.0 * PI * phases[op];
+							if (op == algorithm.feedback) {
+								phase += INDEX * 0.5 * (last + beforeLast);
+							}
+							for (const auto& connection : algorithm.connections) {
+								if (connection.second == op) {
+									phase += INDEX * outputs[connection.first];
+								}
+							}
+							outputs[op] = (float)std::sin(phase);
+							phases[op] += RATIOS[op] * FREQUENCY / SAMPLE_RATE;
+							phases[op] -= std::floor(phases[op]);
+						}
+						beforeLast = last;
+						last = outputs[algorithm.feedback];
+						for (unsigned carrier : algorithm.carriers) {
+							sum += outputs[carrier] / (float)algorithm.carriers.size();
+						}
+						block[i] = sum;
+					}
+					sink = block[0];
+				}) });
+			}
+		}
+	}
+
+	/// <summary>
+	/// Harmonic series with 1 / n amplitudes rendered by the bank and, for comparison,
+	/// with one std::sin per partial per sample
+	/// </summary>
+	void benchmarkSineBank(std::vector<Result>& results) {
+		for (unsigned partials : { 16u, 64u, 256u }) {
+			std::vector<float> amplitudes(partials);
+			for (unsigned k = 0; k < partials; k++) {
+				amplitudes[k] = 1.0f / (float)(k + 1);
+			}
+			// Low enough that every partial is below Nyquist
+			const float frequency = 0.4f * SAMPLE_RATE / (float)partials;
+			Oscillators::SineBank bank(SAMPLE_RATE);
+			bank.setHarmonics(amplitudes, {});
+			std::vector<double> phases(partials, 0.0);
+			const std::string mode = std::to_string(partials) + " partials";
+
+			for (unsigned blockSize : BLOCK_SIZES) {
+				std::vector<float> block(blockSize);
+				results.push_back({ "SineBank", mode, "writeBlock", blockSize, partials, measure(blockSize * partials, [&]() {
+					bank.writeBlock(frequency, blockSize, block.data());
+					sink = block[0];
+				}) });
+				results.push_back({ "SineBank", mode + " std::sin", "writeBlock", blockSize, partials, measure(blockSize * partials, [&]() {
+					for (unsigned i = 0; i < blockSize; i++) {
+						double sum = 0.0;
+						for (unsigned k = 0; k < partials; k++) {
+							sum += amplitudes[k] * std::sin(2.0 * PI * phases[k]);
+							phases[k] += (k + 1) * frequency / SAMPLE_RATE;
+							phases[k] -= std::floor(phases[k]);
+						}
+						block[i] = (float)sum;
+					}
+					sink = block[0];
+				}) });
+			}
+		}
+	}
+
+	/// <summary>
+	/// 5 Hz Sine (std::sin per sample) and naive Triangle LFOs at audio rate, at control rate
+	/// with a point every 32 samples, and as one value per block
+	/// </summary>
+	void benchmarkLfo(std::vector<Result>& results) {
+		const float frequency = 5.0f;
+		Oscillators::Sine sine(SAMPLE_RATE, Oscillators::Accuracy::BIT_ACCURATE);
+		Oscillators::Triangle triangle(SAMPLE_RATE, Oscillators::Antialiasing::NONE);
+		const std::pair<Oscillators::Oscillator*, std::string> lfos[] = { { &sine, "LFO<Sine>" }, { &triangle, "LFO<Triangle>" } };
+
+		for (const auto& lfo : lfos) {
+			Oscillators::Oscillator& oscillator = *lfo.first;
+			for (unsigned blockSize : BLOCK_SIZES) {
+				std::vector<float> block(blockSize);
+				oscillator.setControlRate(1);
+				results.push_back({ lfo.second, "audio rate", "writeBlock", blockSize, 1, measure(blockSize, [&]() {
+					oscillator.writeBlock(frequency, blockSize, block.data());
+					sink = block[0];
+				}) });
+				oscillator.setControlRate(32);
+				results.push_back({ lfo.second, "control rate 32", "writeBlock", blockSize, 1, measure(blockSize, [&]() {
+					oscillator.writeBlock(frequency, blockSize, block.data());
+					sink = block[0];
+				}) });
+				oscillator.setControlRate(1);
+				results.push_back({ lfo.second, "value per block", "getControlValue", blockSize, 1, measure(blockSize, [&]() {
+					sink = oscillator.getControlValue(frequency, blockSize);
+				}) });
+			}
+		}
+	}
+
+	/// <summary>
+	/// 32 sounding voices with one note replaced every block, from the pool and, for comparison,
+	/// built with new on note on and summed from wherever the allocator put them
+	/// </summary>
+	void benchmarkVoicePool(std::vector<Result>& results) {
+		const unsigned voices = 32;
+		const Oscillators::Type types[] = { Oscillators::Type::SAW, Oscillators::Type::SQUARE, Oscillators::Type::SINE, Oscillators::Type::TRIANGLE };
+		auto create = [](const Oscillators::Type& type) -> std::unique_ptr<Oscillators::Oscillator> {
+			switch (type) {
+			case(Oscillators::Type::SAW):
+				return std::make_unique<Oscillators::Saw>(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+			case(Oscillators::Type::SQUARE):
+				return std::make_unique<Oscillators::Square>(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+			case(Oscillators::Type::TRIANGLE):
+				return std::make_unique<Oscillators::Triangle>(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+			default:
+				return std::make_unique<Oscillators::Sine>(SAMPLE_RATE, Oscillators::Accuracy::MINUS_120_DB);
+			}
+		};
+
+		for (unsigned blockSize : BLOCK_SIZES) {
+			std::vector<float> block(blockSize);
+
+			Oscillators::VoicePool pool(voices / 4, SAMPLE_RATE);
+			std::vector<unsigned> ids;
+			for (unsigned voice = 0; voice < voices; voice++) {
+				ids.push_back(pool.noteOn(types[voice % 4], (int)voice, FREQUENCY * (1.0f + 0.01f * voice), 1.0f / voices));
+			}
+			unsigned next = 0;
+			results.push_back({ "VoicePool", "pool", "noteOn+process", blockSize, voices, measure(blockSize * voices, [&]() {
+				const unsigned voice = next++ % voices;
+				pool.release(ids[voice]);
+				ids[voice] = pool.noteOn(types[voice % 4], (int)voice, FREQUENCY * (1.0f + 0.01f * voice), 1.0f / voices);
+				pool.process(blockSize, block.data());
+				sink = block[0];
+			}) });
+
+			std::vector<std::unique_ptr<Oscillators::Oscillator>> allocated;
+			for (unsigned voice = 0; voice < voices; voice++) {
+				allocated.push_back(create(types[voice % 4]));
+			}
+			results.push_back({ "VoicePool", "new/delete", "noteOn+process", blockSize, voices, measure(blockSize * voices, [&]() {
+				const unsigned voice = next++ % voices;
+				allocated[voice] = create(types[voice % 4]);
+				std::fill(block.begin(), block.end(), 0.0f);
+				for (unsigned i = 0; i < voices; i++) {
+					allocated[i]->addBlock(FREQUENCY * (1.0f + 0.01f * i), blockSize, 1.0f / voices, block.data());
+				}
+				sink = block[0];
+			}) });
+		}
+	}
+
+	/// <summary>
+	/// Voices alternate between cheap (Sine) and expensive (crossfaded Wavetable)
+	/// so the threads only stay balanced through work stealing
+	/// </summary>
+	void benchmarkEngine(std::vector<Result>& results, const unsigned& maxThreads) {
+		const unsigned voices = 256;
+		const unsigned blockSize = 256;
+		std::vector<std::unique_ptr<Oscillators::Oscillator>> oscillators;
+		for (unsigned voice = 0; voice < voices; voice++) {
+			if (voice % 2 == 0) {
+				oscillators.emplace_back(new Oscillators::Sine(SAMPLE_RATE, Oscillators::Accuracy::MINUS_120_DB));
+			}
+			else {
+				auto* wavetable = new Oscillators::Wavetable(Oscillators::Type::SAW);
+				wavetable->setSampleRate(SAMPLE_RATE);
+				wavetable->setCrossfade(true);
+				oscillators.emplace_back(wavetable);
+			}
+		}
+
+		for (unsigned threads = 1; threads <= maxThreads; threads++) {
+			Oscillators::RenderEngine engine(threads, blockSize);
+			for (unsigned voice = 0; voice < voices; voice++) {
+				engine.setVoice(engine.addVoice(*oscillators[voice]), FREQUENCY * (1.0f + 0.01f * voice), 1.0f / voices);
+			}
+			std::vector<float> block(blockSize);
+			results.push_back({ "RenderEngine", std::to_string(threads) + " threads", "process", blockSize, voices, measure(blockSize * voices, [&]() {
+				engine.process(blockSize, block.data());
+				sink = block[0];
+			}) });
+		}
+	}
+
+	void writeJson(const std::vector<Result>& results) {
+		std::printf("{\n");
+		std::printf("  \"sampleRate\": %.0f,\n", SAMPLE_RATE);
+		std::printf("  \"frequency\": %.1f,\n", FREQUENCY);
+		std::printf("  \"results\": [\n");
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result& result = results[i];
+			// Voices one core can render in real time at SAMPLE_RATE
+			double voicesPerCore = 1e9 / (result.nsPerSample * SAMPLE_RATE);
+			std::printf("    {\"oscillator\": \"%s\", \"mode\": \"%s\", \"path\": \"%s\", \"blockSize\": %u, \"voices\": %u, \"nsPerSample\": %.4f, \"voicesPerCore\": %.1f}%s\n",
+				result.oscillator.c_str(), result.mode.c_str(), result.path.c_str(), result.blockSize, result.voices,
+				result.nsPerSample, voicesPerCore, (i + 1 < results.size()) ? "," : "");
+		}
+		std::printf("  ]\n");
+		std::printf("}\n");
+	}
+};
+
+int main(int argc, char** argv) {
+	std::string filter;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+			minSeconds = std::atof(argv[++i]) / 1000.0;
+		}
+		else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			filter = argv[++i];
+		}
+		else {
+			std::fprintf(stderr, "usage: %s [--min-time ms] [--filter oscillator]\n", argv[0]);
+			return 1;
+		}
+	}
+	auto selected = [&](const std::string& name) { return filter.empty() || name.find(filter) != std::string::npos; };
+
+	std::vector<Result> results;
+
+	if (selected("Saw")) {
+		Oscillators::Saw naive(SAMPLE_RATE);
+		Oscillators::Saw polyBlep(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+		benchmarkPaths(results, "Saw", "naive", naive);
+		benchmarkPaths(results, "Saw", "polyblep", polyBlep);
+	}
+	if (selected("Square")) {
+		Oscillators::Square naive(SAMPLE_RATE);
+		Oscillators::Square polyBlep(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+		benchmarkPaths(results, "Square", "naive", naive);
+		benchmarkPaths(results, "Square", "polyblep", polyBlep);
+	}
+	if (selected("Triangle")) {
+		Oscillators::Triangle naive(SAMPLE_RATE);
+		Oscillators::Triangle polyBlep(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+		benchmarkPaths(results, "Triangle", "naive", naive);
+		benchmarkPaths(results, "Triangle", "polyblep", polyBlep);
+	}
+	if (selected("Sine")) {
+		Oscillators::Sine exact(SAMPLE_RATE, Oscillators::Accuracy::BIT_ACCURATE);
+		Oscillators::Sine polynomial(SAMPLE_RATE, Oscillators::Accuracy::MINUS_120_DB);
+		Oscillators::Sine phasor(SAMPLE_RATE, Oscillators::Accuracy::MINUS_90_DB);
+		benchmarkPaths(results, "Sine", "bit-accurate", exact);
+		benchmarkPaths(results, "Sine", "-120dB", polynomial);
+		benchmarkPaths(results, "Sine", "-90dB", phasor);
+	}
+	if (selected("Theremin")) {
+		Oscillators::Theremin steady(SAMPLE_RATE);
+		Oscillators::Theremin vibrato(SAMPLE_RATE);
+		steady.setVibrato(5.5f, 0.0f);
+		benchmarkPaths(results, "Theremin", "no vibrato", steady);
+		benchmarkPaths(results, "Theremin", "vibrato", vibrato);
+	}
+	if (selected("Noise")) {
+		Oscillators::Noise white(Oscillators::NoiseColour::WHITE, SAMPLE_RATE);
+		Oscillators::Noise pink(Oscillators::NoiseColour::PINK, SAMPLE_RATE);
+		Oscillators::Noise brown(Oscillators::NoiseColour::BROWN, SAMPLE_RATE);
+		benchmarkPaths(results, "Noise", "white", white);
+		benchmarkPaths(results, "Noise", "pink", pink);
+		benchmarkPaths(results, "Noise", "brown", brown);
+	}
+	if (selected("Wavetable")) {
+		const std::pair<Oscillators::Type, const char*> types[] = {
+			{ Oscillators::Type::SAW, "Wavetable<Saw>" },
+			{ Oscillators::Type::SQUARE, "Wavetable<Square>" },
+			{ Oscillators::Type::SINE, "Wavetable<Sine>" },
+			{ Oscillators::Type::TRIANGLE, "Wavetable<Triangle>" }
+		};
+		for (const auto& type : types) {
+			Oscillators::Wavetable linear(type.first);
+			Oscillators::Wavetable crossfade(type.first);
+			linear.setSampleRate(SAMPLE_RATE);
+			crossfade.setSampleRate(SAMPLE_RATE);
+			crossfade.setCrossfade(true);
+			benchmarkPaths(results, type.second, "linear", linear);
+			benchmarkPaths(results, type.second, "linear+crossfade", crossfade);
+		}
+		const std::pair<Oscillators::InterpolationMode, const char*> modes[] = {
+			{ Oscillators::InterpolationMode::TRUNCATE, "truncate" },
+			{ Oscillators::InterpolationMode::HERMITE, "hermite" },
+			{ Oscillators::InterpolationMode::LAGRANGE, "lagrange" },
+			{ Oscillators::InterpolationMode::OPTIMAL_2X, "optimal-2x" }
+		};
+		for (const auto& mode : modes) {
+			Oscillators::Wavetable saw(Oscillators::Type::SAW);
+			saw.setSampleRate(SAMPLE_RATE);
+			saw.setInterpolation(mode.first);
+			benchmarkPaths(results, "Wavetable<Saw>", mode.second, saw);
+		}
+	}
+	if (selected("FixedWavetable")) {
+		Oscillators::FixedWavetable<2048, Oscillators::Type::SINE> sine(SAMPLE_RATE);
+		Oscillators::FixedWavetable<2048, Oscillators::Type::SAW, 32> saw(SAMPLE_RATE);
+		benchmarkPaths(results, "FixedWavetable<2048, Sine>", "linear", sine);
+		benchmarkPaths(results, "FixedWavetable<2048, Saw, 32>", "linear", saw);
+	}
+	if (selected("BasicOscillator")) {
+		benchmarkBasic<Oscillators::Shapes::Saw, Oscillators::Interpolation::None>(results, "BasicOscillator<Saw>", "naive");
+		benchmarkBasic<Oscillators::Shapes::Square, Oscillators::Interpolation::None>(results, "BasicOscillator<Square>", "naive");
+		benchmarkBasic<Oscillators::Shapes::Triangle, Oscillators::Interpolation::None>(results, "BasicOscillator<Triangle>", "naive");
+		benchmarkBasic<Oscillators::Shapes::Sine, Oscillators::Interpolation::None>(results, "BasicOscillator<Sine>", "-120dB");
+		benchmarkBasic<Oscillators::Shapes::Table, Oscillators::Interpolation::None>(results, "BasicOscillator<Table>", "none");
+		benchmarkBasic<Oscillators::Shapes::Table, Oscillators::Interpolation::Linear>(results, "BasicOscillator<Table>", "linear");
+	}
+	if (selected("Unison")) {
+		benchmarkUnison(results, "Unison<Saw>", "polyblep", Oscillators::Antialiasing::POLYBLEP);
+		benchmarkUnison(results, "Unison<Saw>", "naive", Oscillators::Antialiasing::NONE);
+	}
+	if (selected("Oversampler")) {
+		benchmarkOversampler(results);
+	}
+	if (selected("OperatorGraph")) {
+		benchmarkOperatorGraph(results);
+	}
+	if (selected("SineBank")) {
+		benchmarkSineBank(results);
+	}
+	if (selected("VoicePool")) {
+		benchmarkVoicePool(results);
+	}
+	if (selected("LFO")) {
+		benchmarkLfo(results);
+	}
+	if (selected("RenderEngine")) {
+		unsigned cores = std::thread::hardware_concurrency();
+		benchmarkEngine(results, (cores == 0) ? 1 : cores);
+	}
+	if (selected("OscillatorBank")) {
+		benchmarkBank(results, "OscillatorBank<Saw>", Oscillators::Type::SAW);
+		benchmarkBank(results, "OscillatorBank<Square>", Oscillators::Type::SQUARE);
+		benchmarkBank(results, "OscillatorBank<Sine>", Oscillators::Type::SINE);
+		benchmarkBank(results, "OscillatorBank<Triangle>", Oscillators::Type::TRIANGLE);
+	}
+
+	writeJson(results);
+	return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef LOTKEY_CPP_JUCE_BENCHMARKS_JUCEHEADER_H
+#define LOTKEY_CPP_JUCE_BENCHMARKS_JUCEHEADER_H
+
+// Minimal stand-in for the JUCE project header so the oscillators build
+// without JUCE. Only what the oscillator sources use is provided.
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define jassert(expression) assert(expression)
+#define jassertfalse assert(false)
+
+namespace juce {
+	template <typename FloatType>
+	struct MathConstants {
+		static constexpr FloatType pi = static_cast<FloatType>(3.141592653589793238L);
+		static constexpr FloatType twoPi = static_cast<FloatType>(2 * 3.141592653589793238L);
+	};
+
+	template <typename Type>
+	class AudioBuffer {
+	private:
+		int numChannels = 0, numSamples = 0;
+		std::vector<Type> data;
+	public:
+		AudioBuffer() {}
+		AudioBuffer(int numChannels, int numSamples)
+			: numChannels(numChannels), numSamples(numSamples), data((size_t)(numChannels * numSamples)) {}
+		int getNumChannels() const { return numChannels; }
+		int getNumSamples() const { return numSamples; }
+		Type* getWritePointer(int channel, int sampleIndex = 0) { return data.data() + channel * numSamples + sampleIndex; }
+		const Type* getReadPointer(int channel, int sampleIndex = 0) const { return data.data() + channel * numSamples + sampleIndex; }
+		void copyFrom(int destChannel, int destStartSample, const Type* source, int count) {
+			std::memcpy(getWritePointer(destChannel, destStartSample), source, (size_t)count * sizeof(Type));
+		}
+		void addFrom(int destChannel, int destStartSample, const Type* source, int count, Type gain = Type(1)) {
+			Type* destination = getWritePointer(destChannel, destStartSample);
+			for (int i = 0; i < count; i++) {
+				destination[i] += gain * source[i];
+			}
+		}
+	};
+
+	class File {
+	private:
+		std::string path;
+	public:
+		File(const std::string& path) : path(path) {}
+		const std::string& getFullPathName() const { return path; }
+	};
+
+	class MemoryMappedFile {
+	private:
+		void* address = nullptr;
+		size_t size = 0;
+	public:
+		enum AccessMode { readOnly, readWrite };
+
+		MemoryMappedFile(const File& file, AccessMode mode, bool exclusive = false) {
+			(void)exclusive;
+			int descriptor = open(file.getFullPathName().c_str(), (mode == readOnly) ? O_RDONLY : O_RDWR);
+			if (descriptor < 0) {
+				return;
+			}
+			struct stat info;
+			if (fstat(descriptor, &info) == 0 && info.st_size > 0) {
+				void* mapped = mmap(nullptr, (size_t)info.st_size, (mode == readOnly) ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, descriptor, 0);
+				if (mapped != MAP_FAILED) {
+					address = mapped;
+					size = (size_t)info.st_size;
+				}
+			}
+			close(descriptor);
+		}
+		~MemoryMappedFile() {
+			if (address) {
+				munmap(address, size);
+			}
+		}
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+		void* getData() const { return address; }
+		size_t getSize() const { return size; }
+	};
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include <cmath>
+#include <utility>
+#include "Fft.h"
+
+Oscillators::Fft::Fft(const unsigned& size) {
+	jassert(isPowerOfTwo(size));
+	this->size = size;
+	const unsigned half = size / 2;
+
+	reversed = std::vector<unsigned>(half, 0);
+	unsigned bits = 0;
+	while ((1u << bits) < half) {
+		bits++;
+	}
+	for (unsigned i = 0; i < half; i++) {
+		unsigned reversedIndex = 0;
+		for (unsigned bit = 0; bit < bits; bit++) {
+			reversedIndex |= ((i >> bit) & 1u) << (bits - 1 - bit);
+		}
+		reversed[i] = reversedIndex;
+	}
+
+	twiddles = std::vector<std::complex<double>>(half / 2 + 1);
+	for (unsigned j = 0; j < twiddles.size(); j++) {
+		twiddles[j] = std::polar(1.0, -2.0 * PI * j / half);
+	}
+	realTwiddles = std::vector<std::complex<double>>(half + 1);
+	for (unsigned k = 0; k <= half; k++) {
+		realTwiddles[k] = std::polar(1.0, -2.0 * PI * k / size);
+	}
+	work = std::vector<std::complex<double>>(half);
+}
+
+void Oscillators::Fft::transform() {
+	const unsigned half = size / 2;
+	for (unsigned i = 0; i < half; i++) {
+		if (i < reversed[i]) {
+			std::swap(work[i], work[reversed[i]]);
+		}
+	}
+	for (unsigned length = 2; length <= half; length <<= 1) {
+		const unsigned stride = half / length;
+		for (unsigned start = 0; start < half; start += length) {
+			for (unsigned j = 0; j < length / 2; j++) {
+				const std::complex<double> even = work[start + j];
+				const std::complex<double> odd = work[start + j + length / 2] * twiddles[j * stride];
+				work[start + j] = even + odd;
+				work[start + j + length / 2] = even - odd;
+			}
+		}
+	}
+}
+
+void Oscillators::Fft::forward(const float* input, std::complex<double>* spectrum) {
+	const unsigned half = size / 2;
+	for (unsigned n = 0; n < half; n++) {
+		work[n] = std::complex<double>(input[2 * n], input[2 * n + 1]);
+	}
+	transform();
+
+	// Split the packed spectrum into the spectra of the even and odd samples, then combine them
+	const std::complex<double> i(0.0, 1.0);
+	for (unsigned k = 0; k <= half; k++) {
+		const std::complex<double> packed = work[k % half];
+		const std::complex<double> mirrored = std::conj(work[(half - k) % half]);
+		const std::complex<double> even = 0.5 * (packed + mirrored);
+		const std::complex<double> odd = -0.5 * i * (packed - mirrored);
+		spectrum[k] = even + realTwiddles[k] * odd;
+	}
+}
+
+void Oscillators::Fft::inverse(const std::complex<double>* spectrum, float* output) {
+	const unsigned half = size / 2;
+	const std::complex<double> i(0.0, 1.0);
+	for (unsigned k = 0; k < half; k++) {
+		const std::complex<double> bin = (k == 0) ? std::complex<double>(spectrum[0].real(), 0.0) : spectrum[k];
+		const std::complex<double> mirrored = (k == 0) ? std::complex<double>(spectrum[half].real(), 0.0) : std::conj(spectrum[half - k]);
+		const std::complex<double> even = 0.5 * (bin + mirrored);
+		const std::complex<double> odd = 0.5 * (bin - mirrored) * std::conj(realTwiddles[k]);
+		// Conjugated, so the forward butterflies compute the inverse transform
+		work[k] = std::conj(even + i * odd);
+	}
+	transform();
+
+	const double scale = 1.0 / half;
+	for (unsigned n = 0; n < half; n++) {
+		output[2 * n] = (float)(work[n].real() * scale);
+		output[2 * n + 1] = (float)(-work[n].imag() * scale);
+	}
+}
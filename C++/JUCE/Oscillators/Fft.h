@@ -0,0 +1,58 @@
+#ifndef LOTKEY_CPP_JUCE_FFT_H
+#define LOTKEY_CPP_JUCE_FFT_H
+
+#include <complex>
+#include <vector>
+#include "Oscillators.h"
+
+/// <summary>
+/// Real FFT of a power-of-two size, for building and analysing tables off the audio thread.
+/// The real signal is packed into a complex FFT of half the size (even samples real, odd
+/// samples imaginary) and untangled afterwards, so a transform costs about (N / 4) log2(N / 2)
+/// radix-2 butterflies. Runs in double precision; twiddles and scratch are built once by the
+/// constructor, so a transform never allocates. Not thread safe: use one Fft per thread.
+/// </summary>
+class Oscillators::Fft {
+private:
+	unsigned size = 0;
+	// Bit-reversed order of the half-size complex transform
+	std::vector<unsigned> reversed;
+	// exp(-2 pi i j / (size / 2)) for the butterflies
+	std::vector<std::complex<double>> twiddles;
+	// exp(-2 pi i k / size) for untangling the half-size spectrum
+	std::vector<std::complex<double>> realTwiddles;
+	std::vector<std::complex<double>> work;
+
+	void transform();
+public:
+	/// <summary>
+	/// Check whether a size can be transformed
+	/// </summary>
+	/// <param name="size"> - number of real samples </param>
+	static bool isPowerOfTwo(const unsigned& size) { return size >= 2 && (size & (size - 1)) == 0; }
+	/// <summary>
+	/// Constructor. Allocates, so call off the audio thread.
+	/// </summary>
+	/// <param name="size"> - number of real samples, a power of two of at least 2 </param>
+	Fft(const unsigned& size);
+	/// <summary>
+	/// Get the number of real samples
+	/// </summary>
+	unsigned getSize() const { return size; }
+	/// <summary>
+	/// Transform real samples into bins 0 to size / 2: X[k] = sum x[n] exp(-2 pi i k n / size).
+	/// Unnormalised, so a sine of amplitude a on bin k (0 < k < size / 2) has |X[k]| = a * size / 2.
+	/// </summary>
+	/// <param name="input"> - size samples </param>
+	/// <param name="spectrum"> - size / 2 + 1 bins to write </param>
+	void forward(const float* input, std::complex<double>* spectrum);
+	/// <summary>
+	/// Inverse of forward, including the 1 / size, so inverse(forward(x)) is x.
+	/// The imaginary parts of bins 0 and size / 2 are ignored.
+	/// </summary>
+	/// <param name="spectrum"> - size / 2 + 1 bins </param>
+	/// <param name="output"> - size samples to write </param>
+	void inverse(const std::complex<double>* spectrum, float* output);
+};
+
+#endif
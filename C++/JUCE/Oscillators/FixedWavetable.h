@@ -0,0 +1,183 @@
+#ifndef LOTKEY_CPP_JUCE_FIXEDWAVETABLE_H
+#define LOTKEY_CPP_JUCE_FIXEDWAVETABLE_H
+
+#include <array>
+#include <cstdint>
+#include "Oscillators.h"
+
+/// <summary>
+/// Shape tables generated at compile time into read-only storage
+/// </summary>
+namespace Oscillators::FixedTables {
+	constexpr double TWO_PI = 6.283185307179586476925286766559;
+
+	/// <summary>
+	/// sin usable in constant expressions: range reduction then a Taylor series, error below 1e-11
+	/// </summary>
+	constexpr double sine(double x) {
+		long long turns = (long long)(x / TWO_PI + ((x >= 0.0) ? 0.5 : -0.5));
+		x -= (double)turns * TWO_PI;
+		if (x > TWO_PI / 4.0) {
+			x = TWO_PI / 2.0 - x;
+		}
+		else if (x < -TWO_PI / 4.0) {
+			x = -TWO_PI / 2.0 - x;
+		}
+
+		double term = x, sum = x;
+		for (int n = 1; n < 10; n++) {
+			term *= -x * x / (double)((2 * n) * (2 * n + 1));
+			sum += term;
+		}
+		return sum;
+	}
+
+	/// <summary>
+	/// cos usable in constant expressions
+	/// </summary>
+	constexpr double cosine(const double& x) { return sine(x + TWO_PI / 4.0); }
+
+	/// <summary>
+	/// One cycle of a shape. Harmonics = 0 gives the exact (naive) shape, matching
+	/// Saw, Square and Triangle without anti-aliasing; otherwise the Fourier series is
+	/// summed up to that harmonic, like Wavetables::bandLimitedTable.
+	/// Sine and THEREMIN always give a sine.
+	/// </summary>
+	template <unsigned N, Oscillators::Type ShapeType, unsigned Harmonics>
+	constexpr std::array<float, N> generate() {
+		std::array<float, N> samples{};
+		for (unsigned i = 0; i < N; i++) {
+			const double phase = (double)i / N;
+			const double angle = TWO_PI * phase;
+			double sample = 0.0;
+
+			if (ShapeType != Oscillators::Type::SAW && ShapeType != Oscillators::Type::SQUARE && ShapeType != Oscillators::Type::TRIANGLE) {
+				sample = sine(angle);
+			}
+			else if (Harmonics == 0) {
+				if (ShapeType == Oscillators::Type::SAW) {
+					sample = 2.0 * phase - 1.0;
+				}
+				else if (ShapeType == Oscillators::Type::SQUARE) {
+					sample = (phase < 0.5) ? -1.0 : 1.0;
+				}
+				else {
+					sample = 1.0 - 4.0 * ((phase < 0.5) ? 0.5 - phase : phase - 0.5);
+				}
+			}
+			else {
+				// sin(kx) and cos(kx) by the Chebyshev recurrence, two multiplies per harmonic
+				const double twoCosine = 2.0 * cosine(angle);
+				double sinePrevious = 0.0, sineCurrent = sine(angle);
+				double cosinePrevious = 1.0, cosineCurrent = cosine(angle);
+				for (unsigned k = 1; k <= Harmonics; k++) {
+					if (ShapeType == Oscillators::Type::SAW) {
+						sample += -2.0 / (TWO_PI / 2.0 * k) * sineCurrent;
+					}
+					else if (k % 2 == 1 && ShapeType == Oscillators::Type::SQUARE) {
+						sample += -4.0 / (TWO_PI / 2.0 * k) * sineCurrent;
+					}
+					else if (k % 2 == 1) {
+						sample += -8.0 / (TWO_PI * TWO_PI / 4.0 * k * k) * cosineCurrent;
+					}
+
+					const double sineNext = twoCosine * sineCurrent - sinePrevious;
+					const double cosineNext = twoCosine * cosineCurrent - cosinePrevious;
+					sinePrevious = sineCurrent;
+					sineCurrent = sineNext;
+					cosinePrevious = cosineCurrent;
+					cosineCurrent = cosineNext;
+				}
+			}
+			samples[i] = (float)sample;
+		}
+		return samples;
+	}
+
+	/// <summary>
+	/// Read-only table of N samples, N a power of two.
+	/// Compile time grows with N * Harmonics; keep that product in the tens of thousands.
+	/// </summary>
+	template <unsigned N, Oscillators::Type ShapeType, unsigned Harmonics = 0>
+	struct Table {
+		static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+		static constexpr std::array<float, N> samples = generate<N, ShapeType, Harmonics>();
+	};
+};
+
+/// <summary>
+/// Wavetable oscillator reading a compile-time table of N samples.
+/// N is a power of two, so the phase is a 32-bit fixed-point number whose top
+/// bits are the table index: wrapping is free and neighbours wrap with a bitmask.
+/// There is no mip chain, so use a sine or a low Harmonics count for audio-rate
+/// pitches and the runtime Wavetable when every harmonic up to Nyquist is wanted.
+/// </summary>
+template <unsigned N, Oscillators::Type ShapeType, unsigned Harmonics = 0>
+class Oscillators::FixedWavetable : public Oscillators::Oscillator {
+private:
+	static constexpr unsigned log2(const unsigned& value) { return (value <= 1) ? 0 : 1 + log2(value >> 1); }
+	static constexpr unsigned SHIFT = 32 - log2(N);
+	static constexpr uint32_t FRACTION_MASK = (1u << SHIFT) - 1;
+	static constexpr float FRACTION_SCALE = 1.0f / (float)(1ull << SHIFT);
+
+	float sampleRate = 48000;
+	Oscillators::PhaseAccumulator phase;
+
+	// Replace phases in cycles with the table read at them
+	void read(const unsigned& blockSize, float* block) const {
+		const float* samples = Oscillators::FixedTables::Table<N, ShapeType, Harmonics>::samples.data();
+		for (unsigned i = 0; i < blockSize; i++) {
+			const float position = block[i] * (float)N;
+			const uint32_t index0 = (uint32_t)position & (N - 1);
+			const uint32_t index1 = (index0 + 1) & (N - 1);
+			const float frac = position - (float)(uint32_t)position;
+			block[i] = samples[index0] + frac * (samples[index1] - samples[index0]);
+		}
+	}
+protected:
+	void render(const float& frequency, const unsigned& blockSize, float* block) override {
+		const float* samples = Oscillators::FixedTables::Table<N, ShapeType, Harmonics>::samples.data();
+		phase.setFrequency(frequency, sampleRate);
+		const uint32_t start = phase.getRawPhase();
+		const uint32_t step = phase.getIncrement();
+
+		for (unsigned i = 0; i < blockSize; i++) {
+			const uint32_t current = start + (uint32_t)i * step;
+			const uint32_t index0 = current >> SHIFT;
+			const uint32_t index1 = (index0 + 1) & (N - 1);
+			const float frac = (float)(current & FRACTION_MASK) * FRACTION_SCALE;
+			block[i] = samples[index0] + frac * (samples[index1] - samples[index0]);
+		}
+		phase.advance(blockSize);
+	}
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override {
+		phase.fill(frequencies, sampleRate, blockSize, block);
+		read(blockSize, block);
+	}
+	void renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points) override {
+		phase.fill(frequencies, (double)sampleRate / stride, numPoints, points);
+		read(numPoints, points);
+	}
+public:
+	/// <summary>
+	/// Default constructor
+	/// </summary>
+	FixedWavetable() {}
+	/// <summary>
+	/// Constructor from sample rate
+	/// </summary>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	FixedWavetable(const float& sampleRate) : sampleRate(sampleRate) {}
+	/// <summary>
+	/// Set the sample rate of the oscillator
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) override { this->sampleRate = sampleRate; }
+	/// <summary>
+	/// Restart the phase
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override { phase.reset(cycles); }
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "Oscillators.h"
+
+#if defined(LOTKEY_OSCILLATORS_INSTRUMENTATION)
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define LOTKEY_INSTRUMENTATION_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LOTKEY_INSTRUMENTATION_TSC
+#endif
+
+namespace {
+	// Classes past the first MAX_TYPES, and threads while MAX_THREADS others are recording, are not recorded
+	constexpr unsigned MAX_TYPES = 64;
+	constexpr unsigned MAX_THREADS = 64;
+	// Time constant of the rolling load
+	constexpr double LOAD_SECONDS = 0.3;
+
+	/// <summary>
+	/// Counters written by one thread only, so a relaxed load and store replaces a locked add
+	/// </summary>
+	struct alignas(64) ThreadCounters {
+		std::atomic<bool> claimed{ false };
+		std::atomic<uint64_t> blocks[MAX_TYPES];
+		std::atomic<uint64_t> samples[MAX_TYPES];
+		std::atomic<uint64_t> ticks[MAX_TYPES];
+		std::atomic<uint64_t> callbacks{ 0 };
+		std::atomic<uint64_t> deadlineMisses{ 0 };
+		std::atomic<float> load{ 0.0f };
+	};
+
+	std::atomic<const std::type_info*> types[MAX_TYPES];
+	ThreadCounters threads[MAX_THREADS];
+	thread_local unsigned depth = 0;
+
+	/// <summary>
+	/// The counters a thread has claimed, handed back when the thread exits so threads
+	/// started later (e.g. by each new RenderEngine) can claim them. The totals stay in the
+	/// slot, since snapshot sums every slot whichever thread owns it.
+	/// </summary>
+	struct ThreadSlot {
+		ThreadCounters* counters = nullptr;
+
+		~ThreadSlot() {
+			if (counters) {
+				// A thread that has gone has no load; release publishes its counts to the next owner
+				counters->load.store(0.0f, std::memory_order_relaxed);
+				counters->claimed.store(false, std::memory_order_release);
+			}
+		}
+	};
+	thread_local ThreadSlot slot;
+
+	void add(std::atomic<uint64_t>& counter, const uint64_t& value) {
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	uint64_t now() {
+#if defined(LOTKEY_INSTRUMENTATION_TSC)
+		return (uint64_t)__rdtsc();
+#else
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	ThreadCounters* getThreadCounters() {
+		if (!slot.counters) {
+			for (ThreadCounters& counters : threads) {
+				bool expected = false;
+				if (counters.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+					slot.counters = &counters;
+					break;
+				}
+			}
+		}
+		return slot.counters;
+	}
+
+	/// <summary>
+	/// Slot of a class, registered on first sight with a lock-free insert
+	/// </summary>
+	unsigned getTypeIndex(const std::type_info& type) {
+		for (unsigned i = 0; i < MAX_TYPES; i++) {
+			const std::type_info* registered = types[i].load(std::memory_order_acquire);
+			if (!registered) {
+				if (types[i].compare_exchange_strong(registered, &type, std::memory_order_acq_rel)) {
+					return i;
+				}
+			}
+			// Either it was there, or another thread just registered this slot
+			if (registered == &type || *registered == type) {
+				return i;
+			}
+		}
+		return MAX_TYPES;
+	}
+
+	std::string getName(const std::type_info& type) {
+#if defined(__GNUG__)
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+		if (status == 0 && demangled) {
+			std::string name = demangled;
+			std::free(demangled);
+			return name;
+		}
+#endif
+		return type.name();
+	}
+};
+
+Oscillators::Instrumentation::BlockScope::BlockScope(const std::type_info& type, const unsigned& blockSize) : type(type), blockSize(blockSize), start(0) {
+	if (depth++ == 0) {
+		start = now();
+	}
+}
+
+Oscillators::Instrumentation::BlockScope::~BlockScope() {
+	if (--depth != 0) {
+		return;
+	}
+	const uint64_t elapsed = now() - start;
+	ThreadCounters* counters = getThreadCounters();
+	const unsigned index = getTypeIndex(type);
+	if (!counters || index >= MAX_TYPES) {
+		return;
+	}
+	add(counters->blocks[index], 1);
+	add(counters->samples[index], blockSize);
+	add(counters->ticks[index], elapsed);
+}
+
+Oscillators::Instrumentation::CallbackScope::CallbackScope(const unsigned& blockSize, const double& sampleRate) {
+	deadline = (sampleRate > 0.0) ? (double)blockSize / sampleRate : 0.0;
+	start = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Oscillators::Instrumentation::CallbackScope::~CallbackScope() {
+	const int64_t end = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	const double elapsed = (double)(end - start) * 1e-9;
+	ThreadCounters* counters = getThreadCounters();
+	if (!counters || deadline <= 0.0) {
+		return;
+	}
+	add(counters->callbacks, 1);
+	if (elapsed > deadline) {
+		add(counters->deadlineMisses, 1);
+	}
+	// Exponential average weighted by time, so the window does not depend on the block size
+	const float weight = (float)(deadline / (deadline + LOAD_SECONDS));
+	const float load = counters->load.load(std::memory_order_relaxed);
+	counters->load.store(load + weight * ((float)(elapsed / deadline) - load), std::memory_order_relaxed);
+}
+
+Oscillators::Instrumentation::Snapshot Oscillators::Instrumentation::snapshot() {
+	Snapshot result;
+	for (unsigned i = 0; i < MAX_TYPES; i++) {
+		const std::type_info* type = types[i].load(std::memory_order_acquire);
+		if (!type) {
+			break;
+		}
+		TypeStats stats;
+		stats.name = getName(*type);
+		for (const ThreadCounters& counters : threads) {
+			stats.blocks += counters.blocks[i].load(std::memory_order_relaxed);
+			stats.samples += counters.samples[i].load(std::memory_order_relaxed);
+			stats.ticks += counters.ticks[i].load(std::memory_order_relaxed);
+		}
+		result.types.push_back(stats);
+	}
+	for (const ThreadCounters& counters : threads) {
+		result.callbacks += counters.callbacks.load(std::memory_order_relaxed);
+		result.deadlineMisses += counters.deadlineMisses.load(std::memory_order_relaxed);
+		const float load = counters.load.load(std::memory_order_relaxed);
+		result.load = (load > result.load) ? load : result.load;
+	}
+	return result;
+}
+#else
+Oscillators::Instrumentation::Snapshot Oscillators::Instrumentation::snapshot() {
+	return Snapshot();
+}
+#endif
@@ -0,0 +1,107 @@
+#ifndef LOTKEY_CPP_JUCE_INSTRUMENTATION_H
+#define LOTKEY_CPP_JUCE_INSTRUMENTATION_H
+
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include "Oscillators.h"
+
+/// <summary>
+/// Opt-in render timing. Define LOTKEY_OSCILLATORS_INSTRUMENTATION for the whole project
+/// (every translation unit) to enable it; without it LOTKEY_INSTRUMENT_BLOCK expands to
+/// nothing, CallbackScope is empty and snapshot returns no data, so the render paths are
+/// exactly as fast as if this file did not exist.
+///
+/// When enabled, every public block path of Oscillator times its outermost call per thread
+/// (an Oversampler's block includes its wrapped oscillator, which is not counted again) into
+/// counters for the oscillator's class. Hosts wrap their audio callback in a CallbackScope
+/// to track the load against the block deadline and count the blocks that missed it.
+/// Each thread writes only its own counters, with plain atomic stores and no locks, and
+/// snapshot sums them from any other thread. A thread hands its counters back when it exits,
+/// keeping their totals, so up to 64 threads may record at once however many come and go.
+///
+/// Times are in ticks: TSC cycles on x86, nanoseconds elsewhere.
+/// </summary>
+namespace Oscillators::Instrumentation {
+	/// <summary>
+	/// Totals of one oscillator class
+	/// </summary>
+	struct TypeStats {
+		// Class name, demangled where the compiler allows
+		std::string name;
+		uint64_t blocks = 0;
+		uint64_t samples = 0;
+		uint64_t ticks = 0;
+
+		double getTicksPerBlock() const { return (blocks > 0) ? (double)ticks / (double)blocks : 0.0; }
+		double getTicksPerSample() const { return (samples > 0) ? (double)ticks / (double)samples : 0.0; }
+	};
+
+	/// <summary>
+	/// Totals since the start of the process
+	/// </summary>
+	struct Snapshot {
+		std::vector<TypeStats> types;
+		// Audio callbacks timed by CallbackScope, and how many ran past their deadline
+		uint64_t callbacks = 0;
+		uint64_t deadlineMisses = 0;
+		// Highest rolling load (elapsed / deadline, 1 = 100 %) of any thread running callbacks
+		float load = 0.0f;
+	};
+
+	/// <summary>
+	/// Collect the counters of every thread. Allocates: call from a non-realtime thread.
+	/// </summary>
+	Snapshot snapshot();
+
+#if defined(LOTKEY_OSCILLATORS_INSTRUMENTATION)
+	/// <summary>
+	/// Times a block render; only the outermost scope on a thread records
+	/// </summary>
+	class BlockScope {
+	private:
+		const std::type_info& type;
+		unsigned blockSize;
+		uint64_t start;
+	public:
+		BlockScope(const std::type_info& type, const unsigned& blockSize);
+		~BlockScope();
+		BlockScope(const BlockScope&) = delete;
+		BlockScope& operator=(const BlockScope&) = delete;
+	};
+
+	/// <summary>
+	/// Times an audio callback against its deadline of blockSize / sampleRate seconds.
+	/// The rolling load averages over about the last 300 ms.
+	/// </summary>
+	class CallbackScope {
+	private:
+		double deadline;
+		int64_t start;
+	public:
+		/// <summary>
+		/// Start timing the callback
+		/// </summary>
+		/// <param name="blockSize"> - samples the callback renders </param>
+		/// <param name="sampleRate"> - sample rate (Hz) </param>
+		CallbackScope(const unsigned& blockSize, const double& sampleRate);
+		~CallbackScope();
+		CallbackScope(const CallbackScope&) = delete;
+		CallbackScope& operator=(const CallbackScope&) = delete;
+	};
+#else
+	class CallbackScope {
+	public:
+		CallbackScope(const unsigned&, const double&) {}
+	};
+#endif
+};
+
+#if defined(LOTKEY_OSCILLATORS_INSTRUMENTATION)
+#define LOTKEY_INSTRUMENT_BLOCK(oscillator, blockSize) const Oscillators::Instrumentation::BlockScope lotkeyBlockScope(typeid(oscillator), (blockSize))
+#else
+#define LOTKEY_INSTRUMENT_BLOCK(oscillator, blockSize) ((void)0)
+#endif
+
+#endif
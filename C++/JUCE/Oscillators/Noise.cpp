@@ -0,0 +1,147 @@
+#include <cmath>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "Noise.h"
+
+namespace {
+	constexpr unsigned CHUNK = 64;
+	// Corner of brown noise; below it the spectrum flattens instead of growing without bound
+	constexpr double BROWN_CORNER = 10.0;
+
+	unsigned countTrailingZeros(const uint32_t& value) {
+#if defined(_MSC_VER)
+		unsigned long index = 0;
+		_BitScanForward(&index, value);
+		return (unsigned)index;
+#else
+		return (unsigned)__builtin_ctz(value);
+#endif
+	}
+
+	/// <summary>
+	/// splitmix32 finaliser, so neighbouring seeds and lanes start far apart
+	/// </summary>
+	uint32_t mix(uint32_t value) {
+		value = (value ^ (value >> 16)) * 0x85EBCA6Bu;
+		value = (value ^ (value >> 13)) * 0xC2B2AE35u;
+		return value ^ (value >> 16);
+	}
+};
+
+Oscillators::Noise::Noise(const Oscillators::NoiseColour& colour, const float& sampleRate, const uint32_t& seed) {
+	this->colour = colour;
+	setSampleRate(sampleRate);
+	setSeed(seed);
+}
+
+void Oscillators::Noise::setSampleRate(const float& sampleRate) {
+	this->sampleRate = sampleRate;
+	const double pole = std::exp(-2.0 * PI * BROWN_CORNER / sampleRate);
+	brownPole = (float)pole;
+	// Unit gain on variance: the output has the variance of the white input
+	brownGain = (float)std::sqrt(1.0 - pole * pole);
+}
+
+void Oscillators::Noise::setColour(const Oscillators::NoiseColour& colour) {
+	this->colour = colour;
+}
+
+void Oscillators::Noise::setSeed(const uint32_t& seed) {
+	this->seed = seed;
+	resetPhase(0.0);
+}
+
+void Oscillators::Noise::resetPhase(const double&) {
+	for (unsigned lane = 0; lane < LANES; lane++) {
+		const uint32_t state = mix(seed + lane * 0x9E3779B9u);
+		// xorshift never leaves 0
+		states[lane] = (state != 0) ? state : 0x6D2B79F5u;
+	}
+	numPending = 0;
+	// Rows start drawn, so pink noise is at full level from the first sample
+	fillWhite(PINK_ROWS, rows);
+	rowSum = 0.0;
+	for (unsigned row = 0; row < PINK_ROWS; row++) {
+		rowSum += rows[row];
+	}
+	counter = 0;
+	brown = 0.0f;
+}
+
+void Oscillators::Noise::step(float* samples) {
+	// Local copy, so the lanes are plainly independent and the loop vectorises
+	uint32_t lanes[LANES];
+	for (unsigned lane = 0; lane < LANES; lane++) {
+		lanes[lane] = states[lane];
+	}
+	for (unsigned lane = 0; lane < LANES; lane++) {
+		uint32_t x = lanes[lane];
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		lanes[lane] = x;
+		samples[lane] = (float)(int32_t)x * (1.0f / 2147483648.0f);
+	}
+	for (unsigned lane = 0; lane < LANES; lane++) {
+		states[lane] = lanes[lane];
+	}
+}
+
+void Oscillators::Noise::fillWhite(const unsigned& blockSize, float* block) {
+	unsigned i = 0;
+	for (; i < blockSize && numPending > 0; i++) {
+		block[i] = pending[LANES - numPending--];
+	}
+	for (; i + LANES <= blockSize; i += LANES) {
+		step(block + i);
+	}
+	if (i < blockSize) {
+		step(pending);
+		numPending = LANES;
+		for (; i < blockSize; i++) {
+			block[i] = pending[LANES - numPending--];
+		}
+	}
+}
+
+void Oscillators::Noise::renderNoise(const unsigned& blockSize, float* block) {
+	if (colour == Oscillators::NoiseColour::WHITE) {
+		fillWhite(blockSize, block);
+		return;
+	}
+
+	if (colour == Oscillators::NoiseColour::BROWN) {
+		fillWhite(blockSize, block);
+		float current = brown;
+		for (unsigned i = 0; i < blockSize; i++) {
+			current = brownPole * current + brownGain * block[i];
+			block[i] = current;
+		}
+		brown = current;
+		return;
+	}
+
+	// Two white samples per pink one: a new row value and the white term
+	const float scale = 1.0f / std::sqrt((float)(PINK_ROWS + 1));
+	float white[2 * CHUNK];
+	for (unsigned start = 0; start < blockSize; start += CHUNK) {
+		const unsigned count = (blockSize - start < CHUNK) ? blockSize - start : CHUNK;
+		fillWhite(2 * count, white);
+		for (unsigned i = 0; i < count; i++) {
+			// Row k changes every 2^(k + 1) samples; the top row also takes the wrap of the counter
+			const unsigned row = countTrailingZeros(++counter | (1u << (PINK_ROWS - 1)));
+			rowSum += white[2 * i] - rows[row];
+			rows[row] = white[2 * i];
+			block[start + i] = ((float)rowSum + white[2 * i + 1]) * scale;
+		}
+	}
+}
+
+void Oscillators::Noise::render(const float&, const unsigned& blockSize, float* block) {
+	renderNoise(blockSize, block);
+}
+
+void Oscillators::Noise::render(const float*, const unsigned& blockSize, float* block) {
+	renderNoise(blockSize, block);
+}
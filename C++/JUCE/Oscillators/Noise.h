@@ -0,0 +1,93 @@
+#ifndef LOTKEY_CPP_JUCE_NOISE_H
+#define LOTKEY_CPP_JUCE_NOISE_H
+
+#include <cstdint>
+#include "Oscillators.h"
+
+/// <summary>
+/// Seedable white, pink or brown noise, e.g. for percussion voices. The pitch is ignored.
+/// White noise comes from LANES independent xorshift32 generators stepped side by side,
+/// a loop with no dependency between lanes, so it vectorises like Sine's phasor lanes.
+/// Pink is Voss-McCartney: 16 rows, row k redrawn every 2^(k + 1) samples, plus a white
+/// term, which stays within about 1 dB of -3 dB per octave from a few Hz up at 48 kHz.
+/// Brown is white through a leaky integrator with its corner at 10 Hz.
+/// Every colour has the RMS of the white noise (1 / sqrt(3)); white peaks at 1, pink and
+/// brown can briefly exceed it. The output depends only on the seed and the number of
+/// samples rendered, not on how they are split into blocks.
+/// </summary>
+class Oscillators::Noise : public Oscillators::Oscillator {
+public:
+	/// <summary>
+	/// Generators stepped together
+	/// </summary>
+	static constexpr unsigned LANES = 8;
+private:
+	static constexpr unsigned PINK_ROWS = 16;
+
+	Oscillators::NoiseColour colour = Oscillators::NoiseColour::WHITE;
+	float sampleRate = 48000;
+	uint32_t seed = 1;
+
+	uint32_t states[LANES] = {};
+	// White samples of the last step not used yet, at the end of the array
+	float pending[LANES] = {};
+	unsigned numPending = 0;
+
+	float rows[PINK_ROWS] = {};
+	// Sum of the rows; double, so its rounding never drifts audibly
+	double rowSum = 0.0;
+	uint32_t counter = 0;
+
+	float brown = 0.0f;
+	float brownPole = 0.0f;
+	float brownGain = 0.0f;
+
+	void step(float* samples);
+	void fillWhite(const unsigned& blockSize, float* block);
+	void renderNoise(const unsigned& blockSize, float* block);
+protected:
+	/// <summary>
+	/// Render the next block of noise
+	/// </summary>
+	/// <param name="frequency"> - ignored </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Render the next block of noise
+	/// </summary>
+	/// <param name="frequencies"> - ignored </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
+public:
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="colour"> - spectrum of the noise </param>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	/// <param name="seed"> - seed of the sequence </param>
+	Noise(const Oscillators::NoiseColour& colour, const float& sampleRate, const uint32_t& seed = 1);
+	/// <summary>
+	/// Set the sample rate, which places the corner of brown noise
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) override;
+	/// <summary>
+	/// Set the spectrum of the noise
+	/// </summary>
+	/// <param name="colour"> - new colour </param>
+	void setColour(const Oscillators::NoiseColour& colour);
+	/// <summary>
+	/// Set the seed and restart the sequence from it
+	/// </summary>
+	/// <param name="seed"> - new seed </param>
+	void setSeed(const uint32_t& seed);
+	/// <summary>
+	/// Restart the sequence from the seed, so every hit of a voice is the same noise;
+	/// change the seed between hits to vary them. The phase is ignored.
+	/// </summary>
+	void resetPhase(const double& cycles) override;
+};
+
+#endif
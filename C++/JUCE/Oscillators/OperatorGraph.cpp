@@ -0,0 +1,280 @@
+#include <cmath>
+#include "OperatorGraph.h"
+#include "Simd.h"
+
+namespace {
+	using namespace Oscillators;
+
+	/// <summary>
+	/// destination[i] += gain * source[i]
+	/// </summary>
+	void mix(const float* source, const float& gain, const unsigned& blockSize, float* destination) {
+		const Simd::Float gains = Simd::set(gain);
+		unsigned i = 0;
+		for (; i + Simd::width <= blockSize; i += Simd::width) {
+			Simd::store(destination + i, Simd::mulAdd(gains, Simd::load(source + i), Simd::load(destination + i)));
+		}
+		for (; i < blockSize; i++) {
+			destination[i] += gain * source[i];
+		}
+	}
+
+	/// <summary>
+	/// Shape a phase in cycles (any range): the Sine polynomial, or a mip level read as Wavetable reads it
+	/// </summary>
+	Simd::Float shape(const Wavetables::Table* table, const Simd::Float& phases) {
+		if (!table) {
+			return Simd::sine(Simd::wrap(phases));
+		}
+		return Interpolation::Linear::read(table->samples.get(), table->size, Simd::mul(Simd::wrap(phases), Simd::set((float)table->size)));
+	}
+};
+
+Oscillators::OperatorGraph::OperatorGraph(const unsigned& numOperators, const float& sampleRate) {
+	jassert(numOperators >= 1 && numOperators <= MAX_OPERATORS);
+	this->numOperators = (numOperators < 1) ? 1 : ((numOperators > MAX_OPERATORS) ? MAX_OPERATORS : numOperators);
+	this->sampleRate = sampleRate;
+	compile();
+}
+
+void Oscillators::OperatorGraph::setSampleRate(const float& sampleRate) {
+	this->sampleRate = sampleRate;
+}
+
+void Oscillators::OperatorGraph::setRatio(const unsigned& op, const float& ratio) {
+	jassert(op < numOperators);
+	operators[op].ratio = ratio;
+}
+
+void Oscillators::OperatorGraph::setLevel(const unsigned& op, const float& level) {
+	jassert(op < numOperators);
+	operators[op].level = level;
+}
+
+void Oscillators::OperatorGraph::setWavetable(const unsigned& op, const std::shared_ptr<const Oscillators::Wavetables::MipMap>& mipMap) {
+	jassert(op < numOperators);
+	operators[op].mipMap = (mipMap && !mipMap->levels.empty() && mipMap->levels[0].size > 0) ? mipMap : nullptr;
+}
+
+void Oscillators::OperatorGraph::setModulation(const unsigned& source, const unsigned& destination, const float& index) {
+	jassert(source < numOperators && destination < numOperators);
+	const bool wasConnected = (depths[destination][source] != 0.0f);
+	// Phases are kept in cycles
+	depths[destination][source] = index / (float)(2.0 * PI);
+	if (wasConnected != (index != 0.0f)) {
+		compile();
+	}
+}
+
+void Oscillators::OperatorGraph::clearModulation() {
+	for (unsigned destination = 0; destination < MAX_OPERATORS; destination++) {
+		for (unsigned source = 0; source < MAX_OPERATORS; source++) {
+			depths[destination][source] = 0.0f;
+		}
+	}
+	compile();
+}
+
+void Oscillators::OperatorGraph::retrigger() {
+	resetPhase(0.0);
+}
+
+void Oscillators::OperatorGraph::resetPhase(const double& cycles) {
+	for (Operator& op : operators) {
+		op.phase.reset(cycles);
+		op.last = 0.0f;
+		op.beforeLast = 0.0f;
+	}
+}
+
+void Oscillators::OperatorGraph::compile() {
+	// reaches[a][b]: the output of a flows into b, directly or through other operators
+	bool reaches[MAX_OPERATORS][MAX_OPERATORS] = {};
+	for (unsigned source = 0; source < numOperators; source++) {
+		for (unsigned destination = 0; destination < numOperators; destination++) {
+			reaches[source][destination] = (depths[destination][source] != 0.0f);
+		}
+	}
+	for (unsigned via = 0; via < numOperators; via++) {
+		for (unsigned source = 0; source < numOperators; source++) {
+			for (unsigned destination = 0; destination < numOperators; destination++) {
+				reaches[source][destination] = reaches[source][destination] || (reaches[source][via] && reaches[via][destination]);
+			}
+		}
+	}
+	auto sameLoop = [&reaches](const unsigned& a, const unsigned& b) {
+		return a == b || (reaches[a][b] && reaches[b][a]);
+	};
+
+	// Each step is the lowest operator whose outside modulators are all placed, with the rest
+	// of its loop. The loops form no cycle between them, so one is always ready.
+	bool placed[MAX_OPERATORS] = {};
+	unsigned position[MAX_OPERATORS] = {};
+	unsigned numPlaced = 0;
+	numSteps = 0;
+	while (numPlaced < numOperators) {
+		for (unsigned op = 0; op < numOperators; op++) {
+			if (placed[op]) {
+				continue;
+			}
+			bool ready = true;
+			for (unsigned member = 0; member < numOperators; member++) {
+				if (!sameLoop(op, member)) {
+					continue;
+				}
+				for (unsigned source = 0; source < numOperators; source++) {
+					if (depths[member][source] != 0.0f && !sameLoop(op, source) && !placed[source]) {
+						ready = false;
+					}
+				}
+			}
+			if (!ready) {
+				continue;
+			}
+
+			Step& step = steps[numSteps++];
+			step.first = numPlaced;
+			step.count = 0;
+			step.loop = reaches[op][op];
+			for (unsigned member = 0; member < numOperators; member++) {
+				if (sameLoop(op, member)) {
+					position[member] = numPlaced;
+					order[numPlaced++] = member;
+					placed[member] = true;
+					step.count++;
+				}
+			}
+			break;
+		}
+	}
+
+	for (unsigned destination = 0; destination < numOperators; destination++) {
+		numInputs[destination] = 0;
+		numCurrentInputs[destination] = 0;
+		numDelayedInputs[destination] = 0;
+		for (unsigned source = 0; source < numOperators; source++) {
+			if (depths[destination][source] == 0.0f) {
+				continue;
+			}
+			if (!sameLoop(source, destination)) {
+				inputs[destination][numInputs[destination]++] = source;
+			}
+			else if (position[source] < position[destination]) {
+				currentInputs[destination][numCurrentInputs[destination]++] = source;
+			}
+			else {
+				delayedInputs[destination][numDelayedInputs[destination]++] = source;
+			}
+		}
+	}
+}
+
+const Oscillators::Wavetables::Table* Oscillators::OperatorGraph::getTable(const unsigned& op, const float& maxFrequency) const {
+	const auto& mipMap = operators[op].mipMap;
+	if (!mipMap) {
+		return nullptr;
+	}
+	const float delta = std::fabs(maxFrequency * operators[op].ratio) * (float)mipMap->levels[0].size / sampleRate;
+	return &mipMap->levels[Oscillators::Wavetables::getLevel(*mipMap, delta)];
+}
+
+void Oscillators::OperatorGraph::render(const float& frequency, const unsigned& blockSize, float* block) {
+	for (unsigned op = 0; op < numOperators; op++) {
+		operators[op].phase.setFrequency(frequency * operators[op].ratio, sampleRate);
+	}
+	for (unsigned start = 0; start < blockSize; start += CHUNK_SIZE) {
+		const unsigned chunkSize = (blockSize - start < CHUNK_SIZE) ? blockSize - start : CHUNK_SIZE;
+		renderChunk(&frequency, false, chunkSize, block + start);
+	}
+}
+
+void Oscillators::OperatorGraph::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	for (unsigned start = 0; start < blockSize; start += CHUNK_SIZE) {
+		const unsigned chunkSize = (blockSize - start < CHUNK_SIZE) ? blockSize - start : CHUNK_SIZE;
+		renderChunk(frequencies + start, true, chunkSize, block + start);
+	}
+}
+
+void Oscillators::OperatorGraph::preparePhases(const unsigned& op, const float* frequencies, const bool& perSample, const unsigned& chunkSize) {
+	Operator& current = operators[op];
+	float* output = outputs[op];
+	if (perSample) {
+		for (unsigned i = 0; i < chunkSize; i++) {
+			scaled[i] = frequencies[i] * current.ratio;
+		}
+		current.phase.fill(scaled, sampleRate, chunkSize, output);
+	}
+	else {
+		current.phase.fill(chunkSize, output);
+	}
+	for (unsigned input = 0; input < numInputs[op]; input++) {
+		const unsigned source = inputs[op][input];
+		mix(outputs[source], depths[op][source], chunkSize, output);
+	}
+}
+
+void Oscillators::OperatorGraph::renderChunk(const float* frequencies, const bool& perSample, const unsigned& chunkSize, float* block) {
+	float maxFrequency = std::fabs(frequencies[0]);
+	for (unsigned i = 1; perSample && i < chunkSize; i++) {
+		maxFrequency = std::fmax(maxFrequency, std::fabs(frequencies[i]));
+	}
+
+	for (unsigned s = 0; s < numSteps; s++) {
+		const Step& step = steps[s];
+		for (unsigned k = 0; k < step.count; k++) {
+			preparePhases(order[step.first + k], frequencies, perSample, chunkSize);
+		}
+		if (step.loop) {
+			renderLoop(step, maxFrequency, chunkSize);
+			continue;
+		}
+
+		const unsigned op = order[step.first];
+		const Oscillators::Wavetables::Table* table = getTable(op, maxFrequency);
+		if (table) {
+			Simd::transform(chunkSize, outputs[op], [table](const Simd::Float& phases) { return shape(table, phases); });
+		}
+		else {
+			Simd::transform(chunkSize, outputs[op], [](const Simd::Float& phases) { return Simd::sine(Simd::wrap(phases)); });
+		}
+	}
+
+	for (unsigned i = 0; i < chunkSize; i++) {
+		block[i] = 0.0f;
+	}
+	for (unsigned op = 0; op < numOperators; op++) {
+		if (operators[op].level != 0.0f) {
+			mix(outputs[op], operators[op].level, chunkSize, block);
+		}
+	}
+}
+
+void Oscillators::OperatorGraph::renderLoop(const Step& step, const float& maxFrequency, const unsigned& chunkSize) {
+	const Oscillators::Wavetables::Table* tables[MAX_OPERATORS] = {};
+	for (unsigned k = 0; k < step.count; k++) {
+		tables[k] = getTable(order[step.first + k], maxFrequency);
+	}
+
+	// outputs[op] holds each member's phase plus its outside modulation; only the
+	// modulation from inside the loop is left to add, one sample at a time
+	for (unsigned i = 0; i < chunkSize; i++) {
+		for (unsigned k = 0; k < step.count; k++) {
+			const unsigned op = order[step.first + k];
+			float phase = outputs[op][i];
+			for (unsigned input = 0; input < numCurrentInputs[op]; input++) {
+				const unsigned source = currentInputs[op][input];
+				phase += depths[op][source] * outputs[source][i];
+			}
+			for (unsigned input = 0; input < numDelayedInputs[op]; input++) {
+				const unsigned source = delayedInputs[op][input];
+				phase += depths[op][source] * 0.5f * (operators[source].last + operators[source].beforeLast);
+			}
+			outputs[op][i] = Simd::first(shape(tables[k], Simd::set(phase)));
+		}
+		for (unsigned k = 0; k < step.count; k++) {
+			Operator& current = operators[order[step.first + k]];
+			current.beforeLast = current.last;
+			current.last = outputs[order[step.first + k]][i];
+		}
+	}
+}
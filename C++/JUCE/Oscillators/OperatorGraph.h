@@ -0,0 +1,168 @@
+#ifndef LOTKEY_CPP_JUCE_OPERATORGRAPH_H
+#define LOTKEY_CPP_JUCE_OPERATORGRAPH_H
+
+#include <memory>
+#include "Oscillators.h"
+
+/// <summary>
+/// Phase modulation engine in the style of the DX series: a graph of sine or wavetable
+/// operators, each running at a ratio of the note pitch, whose phases are offset by the
+/// outputs of other operators. Any operator may modulate any other, or itself (feedback).
+///
+/// Connections are compiled into a flat list of steps, modulators before what they modulate.
+/// An operator outside every loop renders each chunk in one vectorised pass: phases from
+/// its PhaseAccumulator, plus its modulators' finished chunks, through the Sine polynomial
+/// or the Wavetable mip level and interpolation. Only the operators of a loop, whose input
+/// depends on their own previous output, are stepped one sample at a time, and even then
+/// their phases and outside modulation are prepared in the vectorised pass first.
+/// Modulation around a loop is the average of the last two outputs, which is what keeps
+/// high feedback from collapsing into noise on the DX7. Each sample of a loop waits on the
+/// sine of the last, so one fed-back operator costs about as much as fifteen vectorised ones.
+///
+/// Changing a depth, ratio or level only writes a number; only connecting or disconnecting
+/// recompiles. The setters are not thread-safe: call them between blocks.
+/// Nothing allocates while rendering.
+/// </summary>
+class Oscillators::OperatorGraph : public Oscillators::Oscillator {
+public:
+	/// <summary>
+	/// Largest number of operators in a graph
+	/// </summary>
+	static constexpr unsigned MAX_OPERATORS = 8;
+	/// <summary>
+	/// Samples rendered per chunk
+	/// </summary>
+	static constexpr unsigned CHUNK_SIZE = 64;
+private:
+	struct Operator {
+		Oscillators::PhaseAccumulator phase;
+		// Null renders a sine
+		std::shared_ptr<const Oscillators::Wavetables::MipMap> mipMap;
+		float ratio = 1.0f;
+		float level = 0.0f;
+		// Last two outputs, read by the operators this one modulates around a loop
+		float last = 0.0f;
+		float beforeLast = 0.0f;
+	};
+
+	/// <summary>
+	/// Operators rendered together: one vectorised operator, or every operator of a loop
+	/// </summary>
+	struct Step {
+		unsigned first = 0;
+		unsigned count = 0;
+		bool loop = false;
+	};
+
+	float sampleRate = 48000;
+	unsigned numOperators = 0;
+	Operator operators[MAX_OPERATORS];
+	// Phase deviation (cycles) of destination per unit output of source
+	float depths[MAX_OPERATORS][MAX_OPERATORS] = {};
+
+	// Compiled evaluation order
+	unsigned order[MAX_OPERATORS] = {};
+	Step steps[MAX_OPERATORS];
+	unsigned numSteps = 0;
+	// Modulators of each operator: finished before its step (read a whole chunk at a time),
+	// earlier in its loop (read this sample) and later in its loop or itself (read the history)
+	unsigned inputs[MAX_OPERATORS][MAX_OPERATORS] = {};
+	unsigned numInputs[MAX_OPERATORS] = {};
+	unsigned currentInputs[MAX_OPERATORS][MAX_OPERATORS] = {};
+	unsigned numCurrentInputs[MAX_OPERATORS] = {};
+	unsigned delayedInputs[MAX_OPERATORS][MAX_OPERATORS] = {};
+	unsigned numDelayedInputs[MAX_OPERATORS] = {};
+
+	alignas(64) float outputs[MAX_OPERATORS][CHUNK_SIZE];
+	alignas(64) float scaled[CHUNK_SIZE];
+
+	void compile();
+	const Oscillators::Wavetables::Table* getTable(const unsigned& op, const float& maxFrequency) const;
+	void preparePhases(const unsigned& op, const float* frequencies, const bool& perSample, const unsigned& chunkSize);
+	void renderLoop(const Step& step, const float& maxFrequency, const unsigned& chunkSize);
+	void renderChunk(const float* frequencies, const bool& perSample, const unsigned& chunkSize, float* block);
+protected:
+	/// <summary>
+	/// Render the sum of the carriers for the next block
+	/// </summary>
+	/// <param name="frequency"> - note pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Render the sum of the carriers for the next block with a note pitch per sample
+	/// </summary>
+	/// <param name="frequencies"> - note pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
+public:
+	/// <summary>
+	/// Constructor. Every operator starts as an unconnected, silent sine at ratio 1.
+	/// </summary>
+	/// <param name="numOperators"> - number of operators, 1 to MAX_OPERATORS </param>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	OperatorGraph(const unsigned& numOperators, const float& sampleRate);
+	/// <summary>
+	/// Set the sample rate of the graph
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) override;
+	/// <summary>
+	/// Get the number of operators
+	/// </summary>
+	unsigned getNumOperators() const { return numOperators; }
+	/// <summary>
+	/// Set the pitch of an operator relative to the note
+	/// </summary>
+	/// <param name="op"> - operator index </param>
+	/// <param name="ratio"> - multiple of the note pitch </param>
+	void setRatio(const unsigned& op, const float& ratio);
+	/// <summary>
+	/// Set how much of an operator is heard. Operators with a level are the carriers.
+	/// </summary>
+	/// <param name="op"> - operator index </param>
+	/// <param name="level"> - gain in the output, 0 for a pure modulator </param>
+	void setLevel(const unsigned& op, const float& level);
+	/// <summary>
+	/// Render an operator from a wavetable instead of a sine.
+	/// The mip level is picked per chunk from the operator's pitch, as Wavetable does,
+	/// and read with linear interpolation. Releases the previous table, so call off the audio thread.
+	/// </summary>
+	/// <param name="op"> - operator index </param>
+	/// <param name="mipMap"> - table to read, null for a sine </param>
+	void setWavetable(const unsigned& op, const std::shared_ptr<const Oscillators::Wavetables::MipMap>& mipMap);
+	/// <summary>
+	/// Set how deeply one operator modulates the phase of another.
+	/// Connecting or disconnecting (a depth becoming or leaving 0) recompiles the graph.
+	/// </summary>
+	/// <param name="source"> - modulating operator </param>
+	/// <param name="destination"> - modulated operator, source itself for feedback </param>
+	/// <param name="index"> - peak phase deviation (radians) at full source output, 0 to disconnect </param>
+	void setModulation(const unsigned& source, const unsigned& destination, const float& index);
+	/// <summary>
+	/// Set how deeply an operator modulates itself, see setModulation
+	/// </summary>
+	/// <param name="op"> - operator index </param>
+	/// <param name="index"> - peak phase deviation (radians), 0 for none </param>
+	void setFeedback(const unsigned& op, const float& index) { setModulation(op, op, index); }
+	/// <summary>
+	/// Disconnect every operator
+	/// </summary>
+	void clearModulation();
+	/// <summary>
+	/// Restart every operator at phase 0 and forget the feedback history. Call on note on.
+	/// </summary>
+	void retrigger();
+	/// <summary>
+	/// Restart every operator at a phase and forget the feedback history
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override;
+	/// <summary>
+	/// Get the number of steps the graph compiled into; the operators of a loop share one
+	/// </summary>
+	unsigned getNumSteps() const { return numSteps; }
+};
+
+#endif
@@ -0,0 +1,360 @@
+#include <algorithm>
+#include "Oscillators.h"
+#include "Simd.h"
+
+namespace {
+	// Ramps are expanded into per-sample pitches this many samples at a time
+	constexpr unsigned RAMP_CHUNK = 256;
+	// Accumulating renders this many samples on the stack at a time, small enough to stay in L1
+	constexpr unsigned ACCUMULATE_CHUNK = 256;
+	// Control rate points rendered per call
+	constexpr unsigned CONTROL_CHUNK = 64;
+
+	/// <summary>
+	/// block += gain * source
+	/// </summary>
+	void addScaled(const unsigned& blockSize, const float& gain, const float* source, float* block) {
+		const Oscillators::Simd::Float gains = Oscillators::Simd::set(gain);
+		Oscillators::Simd::transform(blockSize, block, source, [&gains](const Oscillators::Simd::Float& sample, const Oscillators::Simd::Float& input) {
+			return Oscillators::Simd::mulAdd(input, gains, sample);
+		});
+	}
+};
+
+void Oscillators::Oscillator::prepare(const unsigned& maxBlockSize) {
+	if (scratch.size() < maxBlockSize) {
+		scratch.resize(maxBlockSize);
+	}
+}
+
+float* Oscillators::Oscillator::getBlock(const float& frequency, const unsigned& blockSize) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	if (scratch.size() < blockSize) {
+		// prepare() was not called with a large enough size; this allocates
+		jassertfalse;
+		scratch.resize(blockSize);
+	}
+	renderBlock(frequency, blockSize, scratch.data());
+	return scratch.data();
+}
+
+float* Oscillators::Oscillator::getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	float* block = getBlock(frequency, blockSize);
+	for (unsigned i = 0; i < blockSize; i++) {
+		block[i] *= amplitude;
+	}
+	return block;
+}
+
+void Oscillators::Oscillator::writeBlock(const float& frequency, const unsigned& blockSize, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	renderBlock(frequency, blockSize, block);
+}
+
+void Oscillators::Oscillator::writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	renderBlock(frequency, blockSize, block);
+	for (unsigned i = 0; i < blockSize; i++) {
+		block[i] *= amplitude;
+	}
+}
+
+void Oscillators::Oscillator::writeBlockAmplitudes(const float& frequency, const unsigned& blockSize, const float* amplitudes, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	renderBlock(frequency, blockSize, block);
+	for (unsigned i = 0; i < blockSize; i++) {
+		block[i] *= amplitudes[i];
+	}
+}
+
+void Oscillators::Oscillator::writeBlock(const float* frequencies, const unsigned& blockSize, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	renderBlock(frequencies, blockSize, block);
+}
+
+void Oscillators::Oscillator::writeBlockAmplitudes(const float* frequencies, const unsigned& blockSize, const float* amplitudes, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	renderBlock(frequencies, blockSize, block);
+	for (unsigned i = 0; i < blockSize; i++) {
+		block[i] *= amplitudes[i];
+	}
+}
+
+void Oscillators::Oscillator::writeBlock(const float& startFrequency, const float& endFrequency, const unsigned& blockSize, const float& startAmplitude, const float& endAmplitude, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	if (blockSize == 0) {
+		return;
+	}
+
+	const float frequencyStep = (endFrequency - startFrequency) / blockSize;
+	const float amplitudeStep = (endAmplitude - startAmplitude) / blockSize;
+
+	if (frequencyStep == 0.0f) {
+		renderBlock(startFrequency, blockSize, block);
+	}
+	else {
+		float frequencies[RAMP_CHUNK];
+		for (unsigned start = 0; start < blockSize; start += RAMP_CHUNK) {
+			const unsigned count = (blockSize - start < RAMP_CHUNK) ? blockSize - start : RAMP_CHUNK;
+			for (unsigned i = 0; i < count; i++) {
+				frequencies[i] = startFrequency + frequencyStep * (float)(start + i);
+			}
+			renderBlock(frequencies, count, block + start);
+		}
+	}
+
+	for (unsigned i = 0; i < blockSize; i++) {
+		block[i] *= startAmplitude + amplitudeStep * (float)i;
+	}
+}
+
+void Oscillators::Oscillator::writeBlock(const float& frequency, juce::AudioBuffer<float>& buffer) {
+	writeBlock(frequency, 1.0f, buffer);
+}
+
+void Oscillators::Oscillator::writeBlock(const float& frequency, const float& amplitude, juce::AudioBuffer<float>& buffer) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, (unsigned)buffer.getNumSamples());
+	if (buffer.getNumChannels() == 0) {
+		return;
+	}
+
+	const int numSamples = buffer.getNumSamples();
+	float* first = buffer.getWritePointer(0);
+	writeBlock(frequency, (unsigned)numSamples, amplitude, first);
+
+	for (int channel = 1; channel < buffer.getNumChannels(); channel++) {
+		buffer.copyFrom(channel, 0, first, numSamples);
+	}
+}
+
+void Oscillators::Oscillator::accumulate(const float& frequency, const unsigned& blockSize, const float& gain, float* block) {
+	float chunk[ACCUMULATE_CHUNK];
+	for (unsigned start = 0; start < blockSize; start += ACCUMULATE_CHUNK) {
+		const unsigned count = (blockSize - start < ACCUMULATE_CHUNK) ? blockSize - start : ACCUMULATE_CHUNK;
+		render(frequency, count, chunk);
+		addScaled(count, gain, chunk, block + start);
+	}
+}
+
+void Oscillators::Oscillator::accumulate(const float* frequencies, const unsigned& blockSize, const float& gain, float* block) {
+	float chunk[ACCUMULATE_CHUNK];
+	for (unsigned start = 0; start < blockSize; start += ACCUMULATE_CHUNK) {
+		const unsigned count = (blockSize - start < ACCUMULATE_CHUNK) ? blockSize - start : ACCUMULATE_CHUNK;
+		render(frequencies + start, count, chunk);
+		addScaled(count, gain, chunk, block + start);
+	}
+}
+
+void Oscillators::Oscillator::advance(const float& frequency, const unsigned& samples) {
+	float chunk[ACCUMULATE_CHUNK];
+	for (unsigned start = 0; start < samples; start += ACCUMULATE_CHUNK) {
+		const unsigned count = (samples - start < ACCUMULATE_CHUNK) ? samples - start : ACCUMULATE_CHUNK;
+		render(frequency, count, chunk);
+	}
+}
+
+void Oscillators::Oscillator::renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points) {
+	for (unsigned point = 0; point < numPoints; point++) {
+		render(frequencies[point], 1, points + point);
+		advance(frequencies[point], stride - 1);
+	}
+}
+
+void Oscillators::Oscillator::addBlock(const float& frequency, const unsigned& blockSize, const float& gain, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	accumulateBlock(frequency, blockSize, gain, block);
+}
+
+void Oscillators::Oscillator::addBlock(const float* frequencies, const unsigned& blockSize, const float& gain, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	accumulateBlock(frequencies, blockSize, gain, block);
+}
+
+void Oscillators::Oscillator::writeBlock(const Event* events, const unsigned& numEvents, const unsigned& blockSize, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	renderEvents<false>(events, numEvents, blockSize, 1.0f, block);
+}
+
+void Oscillators::Oscillator::addBlock(const Event* events, const unsigned& numEvents, const unsigned& blockSize, const float& gain, float* block) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	renderEvents<true>(events, numEvents, blockSize, gain, block);
+}
+
+void Oscillators::Oscillator::applyEvent(const Event& event) {
+	switch (event.kind) {
+	case(Event::Kind::FREQUENCY):
+		eventFrequency = event.value;
+		break;
+	case(Event::Kind::AMPLITUDE):
+		eventAmplitude = event.value;
+		break;
+	case(Event::Kind::PHASE_RESET):
+		resetPhase(event.value);
+		break;
+	default:
+		changeTable(event.mipMap);
+		break;
+	}
+}
+
+template <bool Add>
+void Oscillators::Oscillator::renderEvents(const Event* events, const unsigned& numEvents, const unsigned& blockSize, const float& gain, float* block) {
+	unsigned next = 0;
+	unsigned start = 0;
+	while (start < blockSize) {
+		while (next < numEvents && events[next].offset <= start) {
+			// Events must be sorted; a late one still applies, just at the current sample
+			jassert(next == 0 || events[next - 1].offset <= events[next].offset);
+			applyEvent(events[next++]);
+		}
+		const unsigned end = (next < numEvents && events[next].offset < blockSize) ? events[next].offset : blockSize;
+		const unsigned runSize = end - start;
+		// Copied so the loops below do not reload it after every store
+		const float amplitude = eventAmplitude;
+
+		if (amplitude == 0.0f) {
+			if (!Add) {
+				std::fill(block + start, block + end, 0.0f);
+			}
+		}
+		else if (Add) {
+			accumulateBlock(eventFrequency, runSize, gain * amplitude, block + start);
+		}
+		else {
+			renderBlock(eventFrequency, runSize, block + start);
+			if (amplitude != 1.0f) {
+				for (unsigned i = start; i < end; i++) {
+					block[i] *= amplitude;
+				}
+			}
+		}
+		start = end;
+	}
+	while (next < numEvents) {
+		applyEvent(events[next++]);
+	}
+}
+
+void Oscillators::Oscillator::addBlock(const float& frequency, const float& gain, juce::AudioBuffer<float>& buffer) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, (unsigned)buffer.getNumSamples());
+	const int numSamples = buffer.getNumSamples();
+	float chunk[ACCUMULATE_CHUNK];
+	for (int start = 0; start < numSamples; start += (int)ACCUMULATE_CHUNK) {
+		// Render once and add the same chunk to every channel
+		const int count = (numSamples - start < (int)ACCUMULATE_CHUNK) ? numSamples - start : (int)ACCUMULATE_CHUNK;
+		renderBlock(frequency, (unsigned)count, chunk);
+		for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+			buffer.addFrom(channel, start, chunk, count, gain);
+		}
+	}
+}
+
+void Oscillators::Oscillator::setControlRate(const unsigned& decimation) {
+	jassert(decimation > 0);
+	this->decimation = (decimation > 0) ? decimation : 1;
+	controlPrimed = false;
+}
+
+float Oscillators::Oscillator::getControlValue(const float& frequency, const unsigned& blockSize) {
+	LOTKEY_INSTRUMENT_BLOCK(*this, blockSize);
+	float value = 0.0f;
+	if (blockSize > 0) {
+		renderPoints(&frequency, blockSize, 1, &value);
+	}
+	return value;
+}
+
+void Oscillators::Oscillator::renderBlock(const float& frequency, const unsigned& blockSize, float* block) {
+	if (decimation > 1) {
+		renderControl<false>(&frequency, blockSize, block);
+	}
+	else {
+		render(frequency, blockSize, block);
+	}
+}
+
+void Oscillators::Oscillator::renderBlock(const float* frequencies, const unsigned& blockSize, float* block) {
+	if (decimation > 1) {
+		renderControl<true>(frequencies, blockSize, block);
+	}
+	else {
+		render(frequencies, blockSize, block);
+	}
+}
+
+void Oscillators::Oscillator::accumulateBlock(const float& frequency, const unsigned& blockSize, const float& gain, float* block) {
+	if (decimation == 1) {
+		accumulate(frequency, blockSize, gain, block);
+		return;
+	}
+	float chunk[ACCUMULATE_CHUNK];
+	for (unsigned start = 0; start < blockSize; start += ACCUMULATE_CHUNK) {
+		const unsigned count = (blockSize - start < ACCUMULATE_CHUNK) ? blockSize - start : ACCUMULATE_CHUNK;
+		renderControl<false>(&frequency, count, chunk);
+		addScaled(count, gain, chunk, block + start);
+	}
+}
+
+void Oscillators::Oscillator::accumulateBlock(const float* frequencies, const unsigned& blockSize, const float& gain, float* block) {
+	if (decimation == 1) {
+		accumulate(frequencies, blockSize, gain, block);
+		return;
+	}
+	float chunk[ACCUMULATE_CHUNK];
+	for (unsigned start = 0; start < blockSize; start += ACCUMULATE_CHUNK) {
+		const unsigned count = (blockSize - start < ACCUMULATE_CHUNK) ? blockSize - start : ACCUMULATE_CHUNK;
+		renderControl<true>(frequencies + start, count, chunk);
+		addScaled(count, gain, chunk, block + start);
+	}
+}
+
+template <bool PerSample>
+void Oscillators::Oscillator::renderControl(const float* frequencies, const unsigned& blockSize, float* block) {
+	if (blockSize == 0) {
+		return;
+	}
+	// Each point is one sample at the true pitch, then the phase skips to the next point
+	const float scale = (float)decimation;
+	if (!controlPrimed) {
+		renderPoints(frequencies, decimation, 1, &controlEnd);
+		controlPosition = decimation;
+		controlPrimed = true;
+	}
+
+	float points[CONTROL_CHUNK];
+	float pitches[CONTROL_CHUNK];
+	unsigned numPoints = 0;
+	unsigned nextPoint = 0;
+	// Kept in locals while the block is written, which the compiler cannot tell apart from the members
+	unsigned position = controlPosition;
+	float start = controlStart;
+	float end = controlEnd;
+	unsigned i = 0;
+	while (i < blockSize) {
+		if (position == decimation) {
+			if (nextPoint == numPoints) {
+				// Points for the ramps starting at i, i + decimation, ... up to the end of the block
+				const unsigned remaining = (blockSize - i + decimation - 1) / decimation;
+				numPoints = (remaining < CONTROL_CHUNK) ? remaining : CONTROL_CHUNK;
+				nextPoint = 0;
+				for (unsigned point = 0; point < numPoints; point++) {
+					pitches[point] = PerSample ? frequencies[i + point * decimation] : frequencies[0];
+				}
+				renderPoints(pitches, decimation, numPoints, points);
+			}
+			start = end;
+			end = points[nextPoint++];
+			position = 0;
+		}
+
+		const unsigned count = (decimation - position < blockSize - i) ? decimation - position : blockSize - i;
+		// Indexed from the start of the ramp, so the output does not depend on how blocks split it
+		Simd::ramp(count, block + i, start, (end - start) / scale, (float)position);
+		position += count;
+		i += count;
+	}
+	controlPosition = position;
+	controlStart = start;
+	controlEnd = end;
+}
@@ -1,6 +1,7 @@
 #ifndef LOTKEY_CPP_OSCILLATOR_H
 #define LOTKEY_CPP_OSCILLATOR_H
 
+#include <vector>
 #include "Oscillators.h"
 #include "JuceHeader.h"
 
@@ -9,41 +10,173 @@
 #endif
 
 /// <summary>
-/// Abstract base oscillator class
+/// Abstract base oscillator class.
+/// Derived oscillators only implement render; every public block overload
+/// is built on top of it and writes into caller-owned or preallocated memory,
+/// so nothing allocates on the audio thread once prepare has been called.
 /// </summary>
 class Oscillators::Oscillator {
+public:
+	/// <summary>
+	/// Change applied at a sample inside a block, see writeBlock with events
+	/// </summary>
+	struct Event {
+		enum class Kind { FREQUENCY, AMPLITUDE, PHASE_RESET, TABLE };
+		// Sample of the block from which the change applies
+		unsigned offset = 0;
+		Kind kind = Kind::FREQUENCY;
+		// Pitch (Hz), amplitude, or the phase (cycles) to restart at
+		float value = 0.0f;
+		// TABLE only: table to switch to, owned by the caller; null returns to the oscillator's own
+		const Oscillators::Wavetables::MipMap* mipMap = nullptr;
+	};
 private:
 	float sampleRate;
+	std::vector<float> scratch;
+	// Carried between event blocks: silent until an AMPLITUDE event
+	float eventFrequency = 0.0f;
+	float eventAmplitude = 0.0f;
+	// Control rate, see setControlRate: points every decimation samples, ramped in between
+	unsigned decimation = 1;
+	bool controlPrimed = false;
+	// Samples of the current ramp already written, decimation once it is finished
+	unsigned controlPosition = 0;
+	float controlStart = 0.0f;
+	float controlEnd = 0.0f;
 
-	virtual void updateAngleDelta(const float& frequency) = 0;
+	void applyEvent(const Event& event);
+	template <bool Add>
+	void renderEvents(const Event* events, const unsigned& numEvents, const unsigned& blockSize, const float& gain, float* block);
+	template <bool PerSample>
+	void renderControl(const float* frequencies, const unsigned& blockSize, float* block);
+	void renderBlock(const float& frequency, const unsigned& blockSize, float* block);
+	void renderBlock(const float* frequencies, const unsigned& blockSize, float* block);
+	void accumulateBlock(const float& frequency, const unsigned& blockSize, const float& gain, float* block);
+	void accumulateBlock(const float* frequencies, const unsigned& blockSize, const float& gain, float* block);
+protected:
+	/// <summary>
+	/// Render the next block at unit amplitude
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	virtual void render(const float& frequency, const unsigned& blockSize, float* block) = 0;
+	/// <summary>
+	/// Render the next block at unit amplitude with a pitch per sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	virtual void render(const float* frequencies, const unsigned& blockSize, float* block) = 0;
+	/// <summary>
+	/// Add the next block, scaled by gain, onto the samples already in block.
+	/// The default renders into a small stack chunk and adds it while it is still in cache;
+	/// override to fuse the add into the render loop.
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to add to </param>
+	/// <param name="gain"> - gain applied to the oscillator before adding </param>
+	/// <param name="block"> - float* to add to </param>
+	virtual void accumulate(const float& frequency, const unsigned& blockSize, const float& gain, float* block);
+	/// <summary>
+	/// Add the next block with a pitch per sample, scaled by gain, onto the samples already in block
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to add to </param>
+	/// <param name="gain"> - gain applied to the oscillator before adding </param>
+	/// <param name="block"> - float* to add to </param>
+	virtual void accumulate(const float* frequencies, const unsigned& blockSize, const float& gain, float* block);
+	/// <summary>
+	/// Move on by a number of samples at a pitch without writing them.
+	/// The default renders them into a small stack chunk and drops it, which keeps
+	/// anything timed in samples (glides, filters) right.
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the skipped samples </param>
+	/// <param name="samples"> - number of samples to skip </param>
+	virtual void advance(const float& frequency, const unsigned& samples);
+	/// <summary>
+	/// Write every stride-th sample of the next numPoints * stride, for setControlRate and
+	/// getControlValue: each point is the shape at its true pitch, which holds until the next.
+	/// The default renders one sample and advances past the rest, two virtual calls per point;
+	/// override to write all the points in one pass when the phase can simply be stepped.
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each point </param>
+	/// <param name="stride"> - samples from one point to the next </param>
+	/// <param name="numPoints"> - number of points to write </param>
+	/// <param name="points"> - float* to write to </param>
+	virtual void renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points);
 public:
+	virtual ~Oscillator() = default;
 	/// <summary>
 	/// Set the sample rate of the oscillator
 	/// </summary>
 	/// <param name="sampleRate"> - new sample rate </param>
 	virtual void setSampleRate(const float& sampleRate) = 0;
 	/// <summary>
-	/// Get the next block from the oscillator
+	/// Restart the phase, e.g. on note on. Oscillators without a phase ignore it.
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	virtual void resetPhase(const double&) {}
+	/// <summary>
+	/// Switch to another table from the audio thread, between blocks or through a TABLE event.
+	/// The table is owned by the caller and must outlive its use. Oscillators that do not read
+	/// tables ignore it.
+	/// </summary>
+	/// <param name="mipMap"> - table to read, null to return to the oscillator's own </param>
+	virtual void changeTable(const Oscillators::Wavetables::MipMap*) {}
+	/// <summary>
+	/// Preallocate the block returned by getBlock. Call before rendering, off the audio thread.
+	/// </summary>
+	/// <param name="maxBlockSize"> - largest block size that will be requested </param>
+	void prepare(const unsigned& maxBlockSize);
+	/// <summary>
+	/// Run at control rate, for LFOs: the shape is evaluated once every decimation samples
+	/// by rendering one sample at the pitch and advancing past the rest, and the samples
+	/// in between are a linear ramp to the next point. Every block path follows it; addBlock
+	/// then bypasses accumulate overrides. The output trails the shape by at most a ramp.
+	/// Points are the shape at the true pitch, band-limited for the audio rate, so a shape
+	/// with harmonics above half the point rate aliases between the points.
+	/// </summary>
+	/// <param name="decimation"> - samples per evaluated point, 1 for audio rate </param>
+	void setControlRate(const unsigned& decimation);
+	/// <summary>
+	/// Get the control rate decimation
+	/// </summary>
+	/// <returns> samples per evaluated point, 1 at audio rate </returns>
+	unsigned getControlRate() const { return decimation; }
+	/// <summary>
+	/// Get one value for a whole block, for parameter modulation: the shape at the start of
+	/// the block at the true pitch, after which the oscillator advances past the rest of the
+	/// block. It ignores setControlRate; use either it or the block paths on one oscillator.
 	/// </summary>
 	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to return </param>
+	/// <param name="blockSize"> - size of the block the value stands for </param>
+	/// <returns> value of the shape at the start of the block </returns>
+	float getControlValue(const float& frequency, const unsigned& blockSize);
+	/// <summary>
+	/// Get the next block from the oscillator.
+	/// The block is owned by the oscillator and is overwritten by the next call.
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to return, at most the prepared size </param>
 	/// <returns> block as a float* </returns>
-	virtual float* getBlock(const float& frequency, const unsigned& blockSize) = 0;
+	float* getBlock(const float& frequency, const unsigned& blockSize);
 	/// <summary>
-	/// Get the next block from the oscillator
+	/// Get the next block from the oscillator.
+	/// The block is owned by the oscillator and is overwritten by the next call.
 	/// </summary>
 	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to return </param>
+	/// <param name="blockSize"> - size of the block to return, at most the prepared size </param>
 	/// <param name="amplitude"> - amplitude of the block to return </param>
 	/// <returns> block as a float* </returns>
-	virtual float* getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude) = 0;
+	float* getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude);
 	/// <summary>
 	/// Write the next block with the oscillator
 	/// </summary>
 	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
 	/// <param name="blockSize"> - size of the block to write </param>
 	/// <param name="block"> - float* to write to </param>
-	virtual void writeBlock(const float& frequency, const unsigned& blockSize, const float* block) = 0;
+	void writeBlock(const float& frequency, const unsigned& blockSize, float* block);
 	/// <summary>
 	/// Write the next block with the oscillator
 	/// </summary>
@@ -51,7 +184,99 @@ public:
 	/// <param name="blockSize"> - size of the block to write </param>
 	/// <param name="amplitude"> - amplitude of the block to write </param>
 	/// <param name="block"> - float* to write to </param>
-	virtual void writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) = 0;
+	void writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, float* block);
+	/// <summary>
+	/// Write the next block with an amplitude per sample. Named apart from writeBlock so
+	/// writeBlock(frequency, blockSize, 0, block) is a silent block, not an ambiguous call.
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="amplitudes"> - amplitude of each sample </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlockAmplitudes(const float& frequency, const unsigned& blockSize, const float* amplitudes, float* block);
+	/// <summary>
+	/// Write the next block with a pitch per sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlock(const float* frequencies, const unsigned& blockSize, float* block);
+	/// <summary>
+	/// Write the next block with a pitch and amplitude per sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="amplitudes"> - amplitude of each sample </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlockAmplitudes(const float* frequencies, const unsigned& blockSize, const float* amplitudes, float* block);
+	/// <summary>
+	/// Write the next block with pitch and amplitude ramping linearly across it
+	/// </summary>
+	/// <param name="startFrequency"> - pitch (Hz) of the first sample </param>
+	/// <param name="endFrequency"> - pitch (Hz) reached after the last sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="startAmplitude"> - amplitude of the first sample </param>
+	/// <param name="endAmplitude"> - amplitude reached after the last sample </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlock(const float& startFrequency, const float& endFrequency, const unsigned& blockSize, const float& startAmplitude, const float& endAmplitude, float* block);
+	/// <summary>
+	/// Write the next block, applying each event at its sample.
+	/// The block is split at the events and every run between them is rendered with the
+	/// constant pitch kernel, so changes are sample-accurate at the cost of one render per run.
+	/// Pitch and amplitude carry over to the next block; the first block starts silent at 0 Hz.
+	/// A silent run is not rendered, so the phase holds still until the amplitude returns.
+	/// </summary>
+	/// <param name="events"> - events sorted by offset; offsets past the block apply after it </param>
+	/// <param name="numEvents"> - number of events </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlock(const Event* events, const unsigned& numEvents, const unsigned& blockSize, float* block);
+	/// <summary>
+	/// Write the next block to every channel of a buffer
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="buffer"> - buffer to write to </param>
+	void writeBlock(const float& frequency, juce::AudioBuffer<float>& buffer);
+	/// <summary>
+	/// Write the next block to every channel of a buffer
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="amplitude"> - amplitude of the block to write </param>
+	/// <param name="buffer"> - buffer to write to </param>
+	void writeBlock(const float& frequency, const float& amplitude, juce::AudioBuffer<float>& buffer);
+	/// <summary>
+	/// Add the next block onto block instead of overwriting it, so voices can be
+	/// summed straight into a bus without a buffer per voice
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to add to </param>
+	/// <param name="gain"> - gain applied to the oscillator before adding </param>
+	/// <param name="block"> - float* to add to </param>
+	void addBlock(const float& frequency, const unsigned& blockSize, const float& gain, float* block);
+	/// <summary>
+	/// Add the next block with a pitch per sample onto block instead of overwriting it
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to add to </param>
+	/// <param name="gain"> - gain applied to the oscillator before adding </param>
+	/// <param name="block"> - float* to add to </param>
+	void addBlock(const float* frequencies, const unsigned& blockSize, const float& gain, float* block);
+	/// <summary>
+	/// Add the next block onto block, applying each event at its sample, see writeBlock with events
+	/// </summary>
+	/// <param name="events"> - events sorted by offset; offsets past the block apply after it </param>
+	/// <param name="numEvents"> - number of events </param>
+	/// <param name="blockSize"> - size of the block to add to </param>
+	/// <param name="gain"> - gain applied to the oscillator before adding </param>
+	/// <param name="block"> - float* to add to </param>
+	void addBlock(const Event* events, const unsigned& numEvents, const unsigned& blockSize, const float& gain, float* block);
+	/// <summary>
+	/// Add the next block onto every channel of a buffer
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="gain"> - gain applied to the oscillator before adding </param>
+	/// <param name="buffer"> - buffer to add to </param>
+	void addBlock(const float& frequency, const float& gain, juce::AudioBuffer<float>& buffer);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "OscillatorBank.h"
+#include "Simd.h"
+
+namespace {
+	struct SawShape { static Oscillators::Simd::Float evaluate(const Oscillators::Simd::Float& phase) { return Oscillators::Simd::saw(phase); } };
+	struct SquareShape { static Oscillators::Simd::Float evaluate(const Oscillators::Simd::Float& phase) { return Oscillators::Simd::square(phase); } };
+	struct SineShape { static Oscillators::Simd::Float evaluate(const Oscillators::Simd::Float& phase) { return Oscillators::Simd::sine(phase); } };
+	struct TriangleShape { static Oscillators::Simd::Float evaluate(const Oscillators::Simd::Float& phase) { return Oscillators::Simd::triangle(phase); } };
+};
+
+Oscillators::OscillatorBank::OscillatorBank(const Oscillators::Type& type, const float& sampleRate, const unsigned& numVoices) {
+	this->type = type;
+	this->sampleRate = sampleRate;
+	this->numVoices = numVoices;
+
+	// Pad to a whole number of vectors; padding voices stay silent
+	unsigned paddedSize = (numVoices + Simd::width - 1) / Simd::width * Simd::width;
+	phases = std::vector<float>(paddedSize, 0.0f);
+	phaseDeltas = std::vector<float>(paddedSize, 0.0f);
+	amplitudes = std::vector<float>(paddedSize, 0.0f);
+	frequencies = std::vector<float>(paddedSize, 0.0f);
+}
+
+void Oscillators::OscillatorBank::setSampleRate(const float& sampleRate) {
+	this->sampleRate = sampleRate;
+	for (unsigned i = 0; i < numVoices; i++) {
+		phaseDeltas[i] = frequencies[i] / sampleRate;
+	}
+}
+
+void Oscillators::OscillatorBank::setType(const Oscillators::Type& type) {
+	this->type = type;
+}
+
+void Oscillators::OscillatorBank::setVoice(const unsigned& voice, const float& frequency, const float& amplitude) {
+	setFrequency(voice, frequency);
+	setAmplitude(voice, amplitude);
+}
+
+void Oscillators::OscillatorBank::setFrequency(const unsigned& voice, const float& frequency) {
+	jassert(voice < numVoices && frequency >= 0.0f);
+	frequencies[voice] = frequency;
+	phaseDeltas[voice] = frequency / sampleRate;
+}
+
+void Oscillators::OscillatorBank::setAmplitude(const unsigned& voice, const float& amplitude) {
+	jassert(voice < numVoices);
+	amplitudes[voice] = amplitude;
+}
+
+void Oscillators::OscillatorBank::resetPhase(const unsigned& voice, const float& phase) {
+	jassert(voice < numVoices);
+	phases[voice] = phase - std::floor(phase);
+}
+
+void Oscillators::OscillatorBank::writeBlock(const unsigned& blockSize, float* block) {
+	renderType<false>(blockSize, 1.0f, block);
+}
+
+void Oscillators::OscillatorBank::addBlock(const unsigned& blockSize, const float& gain, float* block) {
+	renderType<true>(blockSize, gain, block);
+}
+
+template <bool Accumulate>
+void Oscillators::OscillatorBank::renderType(const unsigned& blockSize, const float& gain, float* block) {
+	switch (type) {
+	case(Oscillators::Type::SAW):
+		render<SawShape, Accumulate>(blockSize, gain, block);
+		break;
+	case(Oscillators::Type::SQUARE):
+		render<SquareShape, Accumulate>(blockSize, gain, block);
+		break;
+	case(Oscillators::Type::TRIANGLE):
+		render<TriangleShape, Accumulate>(blockSize, gain, block);
+		break;
+	default:
+		render<SineShape, Accumulate>(blockSize, gain, block);
+		break;
+	}
+}
+
+template <typename Shape, bool Accumulate>
+void Oscillators::OscillatorBank::render(const unsigned& blockSize, const float& gain, float* block) {
+	const unsigned size = (unsigned)phases.size();
+	float* phase = phases.data();
+	const float* phaseDelta = phaseDeltas.data();
+	const float* amplitude = amplitudes.data();
+
+	for (unsigned i = 0; i < blockSize; i++) {
+		Simd::Float sum = Simd::set(0.0f);
+		for (unsigned v = 0; v < size; v += Simd::width) {
+			Simd::Float current = Simd::load(phase + v);
+			sum = Simd::mulAdd(Shape::evaluate(current), Simd::load(amplitude + v), sum);
+			Simd::store(phase + v, Simd::wrap(Simd::add(current, Simd::load(phaseDelta + v))));
+		}
+		if (Accumulate) {
+			block[i] += gain * Simd::sum(sum);
+		}
+		else {
+			block[i] = Simd::sum(sum);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef LOTKEY_CPP_JUCE_OSCILLATORBANK_H
+#define LOTKEY_CPP_JUCE_OSCILLATORBANK_H
+
+#include <vector>
+#include "Oscillators.h"
+
+/// <summary>
+/// Renders many voices of the same shape in one pass.
+/// Phase, phase increment and amplitude are stored as structure-of-arrays
+/// and processed Simd::width voices per instruction.
+/// </summary>
+class Oscillators::OscillatorBank {
+private:
+	Oscillators::Type type = Oscillators::Type::SINE;
+	float sampleRate = 48000;
+	unsigned numVoices = 0;
+	std::vector<float> phases;
+	std::vector<float> phaseDeltas;
+	std::vector<float> amplitudes;
+	std::vector<float> frequencies;
+
+	template <typename Shape, bool Accumulate>
+	void render(const unsigned& blockSize, const float& gain, float* block);
+	template <bool Accumulate>
+	void renderType(const unsigned& blockSize, const float& gain, float* block);
+public:
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="type"> - shape of every voice in the bank </param>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	/// <param name="numVoices"> - number of voices to allocate </param>
+	OscillatorBank(const Oscillators::Type& type, const float& sampleRate, const unsigned& numVoices);
+	/// <summary>
+	/// Set the sample rate of every voice
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate);
+	/// <summary>
+	/// Set the shape of every voice
+	/// </summary>
+	/// <param name="type"> - new shape </param>
+	void setType(const Oscillators::Type& type);
+	/// <summary>
+	/// Get the shape of the voices
+	/// </summary>
+	Oscillators::Type getType() const { return type; }
+	/// <summary>
+	/// Get the number of voices in the bank
+	/// </summary>
+	unsigned getNumVoices() const { return numVoices; }
+	/// <summary>
+	/// Set the pitch and amplitude of a voice. An amplitude of 0 silences the voice.
+	/// </summary>
+	/// <param name="voice"> - index of the voice </param>
+	/// <param name="frequency"> - pitch (Hz), must not be negative </param>
+	/// <param name="amplitude"> - amplitude of the voice </param>
+	void setVoice(const unsigned& voice, const float& frequency, const float& amplitude);
+	/// <summary>
+	/// Set the pitch of a voice
+	/// </summary>
+	/// <param name="voice"> - index of the voice </param>
+	/// <param name="frequency"> - pitch (Hz), must not be negative </param>
+	void setFrequency(const unsigned& voice, const float& frequency);
+	/// <summary>
+	/// Set the amplitude of a voice
+	/// </summary>
+	/// <param name="voice"> - index of the voice </param>
+	/// <param name="amplitude"> - amplitude of the voice </param>
+	void setAmplitude(const unsigned& voice, const float& amplitude);
+	/// <summary>
+	/// Reset the phase of a voice
+	/// </summary>
+	/// <param name="voice"> - index of the voice </param>
+	/// <param name="phase"> - new phase in cycles [0, 1) </param>
+	void resetPhase(const unsigned& voice, const float& phase = 0.0f);
+	/// <summary>
+	/// Write the sum of all voices for the next block
+	/// </summary>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void writeBlock(const unsigned& blockSize, float* block);
+	/// <summary>
+	/// Add the sum of all voices, scaled by gain, onto the samples already in block
+	/// </summary>
+	/// <param name="blockSize"> - size of the block to add to </param>
+	/// <param name="gain"> - gain applied to the sum before adding </param>
+	/// <param name="block"> - float* to add to </param>
+	void addBlock(const unsigned& blockSize, const float& gain, float* block);
+};
+
+#endif
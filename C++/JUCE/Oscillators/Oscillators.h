@@ -1,14 +1,14 @@
 #ifndef LOTKEY_CPP_OSCILLATORS_H
 #define LOTKEY_CPP_OSCILLATORS_H
-#define WAVETABLE_SIZE 100
+#define WAVETABLE_SIZE 2048
+
+#include <cstddef>
 
 /// <summary>
 /// Namespace for all oscillator types
 /// </summary>
 namespace Oscillators {
 
-	namespace Wavetables;
-
 	enum class Type {
 		SAW,
 		SQUARE,
@@ -17,21 +17,105 @@ namespace Oscillators {
 		THEREMIN
 	};
 
+	/// <summary>
+	/// Accuracy tiers for oscillators with approximate render paths
+	/// </summary>
+	enum class Accuracy {
+		BIT_ACCURATE,
+		MINUS_120_DB,
+		MINUS_90_DB
+	};
+
+	/// <summary>
+	/// Anti-aliasing for the analytic oscillators. NONE keeps the naive shape (best for LFOs).
+	/// </summary>
+	enum class Antialiasing {
+		NONE,
+		POLYBLEP
+	};
+
+	/// <summary>
+	/// Interpolation used by Wavetable, see the Interpolation namespace for the quality/cost of each
+	/// </summary>
+	enum class InterpolationMode {
+		TRUNCATE,
+		LINEAR,
+		HERMITE,
+		LAGRANGE,
+		OPTIMAL_2X
+	};
+
+	/// <summary>
+	/// Which voice VoicePool takes over when every voice of a type is sounding.
+	/// SAME_NOTE first retriggers a voice already playing the note instead of stacking
+	/// another, and otherwise steals the oldest.
+	/// </summary>
+	enum class VoiceStealing {
+		OLDEST,
+		QUIETEST,
+		SAME_NOTE
+	};
+
+	/// <summary>
+	/// Spectrum of Noise: flat, -3 dB per octave or -6 dB per octave
+	/// </summary>
+	enum class NoiseColour {
+		WHITE,
+		PINK,
+		BROWN
+	};
+
+	class Fft;
+	class Noise;
 	class Oscillator;
+	class PhaseAccumulator;
+	class OscillatorBank;
+	class OperatorGraph;
+	class Oversampler;
+	class RenderEngine;
 	class Saw;
+	class SineBank;
 	class Square;
 	class Sine;
 	class Triangle;
+	class Theremin;
+	class Unison;
+	class VoicePool;
 	class Wavetable;
+
+	template <typename Shape, typename Interp>
+	class BasicOscillator;
+	template <typename Shape, typename Interp>
+	class OscillatorAdapter;
+	template <unsigned N, Type ShapeType, unsigned Harmonics>
+	class FixedWavetable;
+	template <typename T, size_t Capacity>
+	class SpscQueue;
 	
 };
 
+#include "SpscQueue.h"
+#include "Instrumentation.h"
+#include "Fft.h"
 #include "Wavetables.h"
+#include "Interpolation.h"
 #include "Oscillator.h"
+#include "PhaseAccumulator.h"
 #include "Saw.h"
 #include "Square.h"
 #include "Sine.h"
 #include "Triangle.h"
+#include "Theremin.h"
+#include "Noise.h"
 #include "Wavetable.h"
+#include "OscillatorBank.h"
+#include "Unison.h"
+#include "SineBank.h"
+#include "Oversampler.h"
+#include "OperatorGraph.h"
+#include "BasicOscillator.h"
+#include "FixedWavetable.h"
+#include "RenderEngine.h"
+#include "VoicePool.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+#include "Oversampler.h"
+#include "Simd.h"
+
+namespace {
+	/// <summary>
+	/// Nonzero taps per half of a half-band stage and the beta of its Kaiser window
+	/// </summary>
+	struct StageDesign {
+		unsigned taps;
+		double beta;
+	};
+
+	/// <summary>
+	/// Stages for at least 100 dB of rejection, the last stage (at twice the output rate) first.
+	/// It passes 0.21 and stops from 0.29 of its input rate. The earlier stages only have to keep
+	/// their images out of the final passband, so they stop from 0.395 and 0.4475 and a short,
+	/// steeply windowed filter is enough.
+	/// </summary>
+	const StageDesign STAGE_DESIGNS[] = { { 22, 10.06 }, { 7, 12.0 }, { 5, 12.0 } };
+
+	double besselI0(const double& x) {
+		double sum = 1.0;
+		double term = 1.0;
+		for (unsigned k = 1; k < 50; k++) {
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	/// <summary>
+	/// Kaiser-windowed half-band: the sinc taps at odd distances from the centre,
+	/// outermost first, scaled so the filter has unit gain at DC
+	/// </summary>
+	std::vector<float> halfBandCoefficients(const unsigned& taps, const double& beta) {
+		std::vector<double> coefficients(taps);
+		double sum = 0.0;
+		for (unsigned i = 0; i < taps; i++) {
+			double distance = 2.0 * (taps - i) - 1.0;
+			double window = besselI0(beta * std::sqrt(1.0 - std::pow(distance / (2.0 * taps), 2.0))) / besselI0(beta);
+			coefficients[i] = std::sin(PI * distance / 2.0) / (PI * distance) * window;
+			sum += coefficients[i];
+		}
+
+		std::vector<float> normalised(taps);
+		for (unsigned i = 0; i < taps; i++) {
+			// Both halves together sum to 0.5, the centre tap to the other 0.5
+			normalised[i] = (float)(coefficients[i] * 0.25 / sum);
+		}
+		return normalised;
+	}
+};
+
+Oscillators::Oversampler::Oversampler(Oscillators::Oscillator& oscillator, const unsigned& factor, const float& sampleRate) {
+	jassert(factor == 2 || factor == 4 || factor == 8);
+	this->oscillator = &oscillator;
+	this->factor = (factor >= 8) ? 8 : ((factor >= 4) ? 4 : 2);
+
+	unsigned numStages = (this->factor == 8) ? 3 : ((this->factor == 4) ? 2 : 1);
+	stages = std::vector<Stage>(numStages);
+	unsigned inputSize = CHUNK_SIZE * this->factor;
+	for (unsigned s = 0; s < numStages; s++) {
+		// stages[0] runs first, at the highest rate
+		Stage& stage = stages[s];
+		const StageDesign& design = STAGE_DESIGNS[numStages - 1 - s];
+		const unsigned taps = design.taps;
+		stage.coefficients = halfBandCoefficients(taps, design.beta);
+		stage.evenHistory = 2 * taps - 1;
+		stage.oddHistory = taps;
+		stage.even = std::vector<float>(stage.evenHistory + inputSize / 2, 0.0f);
+		stage.odd = std::vector<float>(stage.oddHistory + inputSize / 2, 0.0f);
+		inputSize /= 2;
+	}
+	oversampled = std::vector<float>(CHUNK_SIZE * this->factor, 0.0f);
+	frequencies = std::vector<float>(CHUNK_SIZE * this->factor, 0.0f);
+
+	setSampleRate(sampleRate);
+}
+
+void Oscillators::Oversampler::setSampleRate(const float& sampleRate) {
+	this->sampleRate = sampleRate;
+	oscillator->setSampleRate(sampleRate * (float)factor);
+}
+
+float Oscillators::Oversampler::getLatency() const {
+	// A stage delays by half its length at its input rate
+	float latency = 0.0f;
+	float rate = (float)factor;
+	for (const Stage& stage : stages) {
+		latency += (float)stage.evenHistory / rate;
+		rate *= 0.5f;
+	}
+	return latency;
+}
+
+void Oscillators::Oversampler::reset() {
+	for (Stage& stage : stages) {
+		std::fill(stage.even.begin(), stage.even.end(), 0.0f);
+		std::fill(stage.odd.begin(), stage.odd.end(), 0.0f);
+	}
+}
+
+void Oscillators::Oversampler::resetPhase(const double& cycles) {
+	oscillator->resetPhase(cycles);
+}
+
+void Oscillators::Oversampler::changeTable(const Oscillators::Wavetables::MipMap* mipMap) {
+	oscillator->changeTable(mipMap);
+}
+
+void Oscillators::Oversampler::render(const float& frequency, const unsigned& blockSize, float* block) {
+	for (unsigned start = 0; start < blockSize; start += CHUNK_SIZE) {
+		const unsigned chunkSize = (blockSize - start < CHUNK_SIZE) ? blockSize - start : CHUNK_SIZE;
+		oscillator->writeBlock(frequency, chunkSize * factor, oversampled.data());
+		decimateChunk(chunkSize, block + start);
+	}
+}
+
+void Oscillators::Oversampler::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	for (unsigned start = 0; start < blockSize; start += CHUNK_SIZE) {
+		const unsigned chunkSize = (blockSize - start < CHUNK_SIZE) ? blockSize - start : CHUNK_SIZE;
+		for (unsigned i = 0; i < chunkSize * factor; i++) {
+			this->frequencies[i] = frequencies[start + i / factor];
+		}
+		oscillator->writeBlock(this->frequencies.data(), chunkSize * factor, oversampled.data());
+		decimateChunk(chunkSize, block + start);
+	}
+}
+
+void Oscillators::Oversampler::decimateChunk(const unsigned& chunkSize, float* block) {
+	// Every stage but the last decimates in place: its input has been split into the branches before it writes
+	unsigned outputSize = chunkSize * factor / 2;
+	for (unsigned s = 0; s < stages.size(); s++) {
+		float* output = (s + 1 == stages.size()) ? block : oversampled.data();
+		decimate(stages[s], oversampled.data(), outputSize, output);
+		outputSize /= 2;
+	}
+}
+
+void Oscillators::Oversampler::decimate(Stage& stage, const float* input, const unsigned& outputSize, float* output) {
+	float* even = stage.even.data();
+	float* odd = stage.odd.data();
+	const unsigned taps = (unsigned)stage.coefficients.size();
+	const float* coefficients = stage.coefficients.data();
+
+	unsigned n = 0;
+	for (; n + Simd::width <= outputSize; n += Simd::width) {
+		Simd::Float evenSamples, oddSamples;
+		Simd::deinterleave(input + 2 * n, evenSamples, oddSamples);
+		Simd::store(even + stage.evenHistory + n, evenSamples);
+		Simd::store(odd + stage.oddHistory + n, oddSamples);
+	}
+	for (; n < outputSize; n++) {
+		even[stage.evenHistory + n] = input[2 * n];
+		odd[stage.oddHistory + n] = input[2 * n + 1];
+	}
+
+	// y[n] = 0.5 * odd[n - taps] + sum of c[i] * (even[n - i] + even[n - (2 * taps - 1) + i])
+	// with every index relative to the first new sample of its branch
+	const float* centre = odd + stage.oddHistory - taps;
+	const float* newest = even + stage.evenHistory;
+	const float* oldest = even + stage.evenHistory - (2 * taps - 1);
+	n = 0;
+	// Two output vectors with two partial sums each, so four multiply-add chains are in flight
+	for (; n + 2 * Simd::width <= outputSize; n += 2 * Simd::width) {
+		const unsigned m = n + Simd::width;
+		Simd::Float first = Simd::mul(Simd::set(0.5f), Simd::load(centre + n));
+		Simd::Float second = Simd::mul(Simd::set(0.5f), Simd::load(centre + m));
+		Simd::Float firstOdd = Simd::set(0.0f);
+		Simd::Float secondOdd = Simd::set(0.0f);
+		unsigned i = 0;
+		for (; i + 1 < taps; i += 2) {
+			const Simd::Float c0 = Simd::set(coefficients[i]);
+			const Simd::Float c1 = Simd::set(coefficients[i + 1]);
+			first = Simd::mulAdd(c0, Simd::add(Simd::load(newest - i + n), Simd::load(oldest + n + i)), first);
+			second = Simd::mulAdd(c0, Simd::add(Simd::load(newest - i + m), Simd::load(oldest + m + i)), second);
+			firstOdd = Simd::mulAdd(c1, Simd::add(Simd::load(newest - (i + 1) + n), Simd::load(oldest + n + i + 1)), firstOdd);
+			secondOdd = Simd::mulAdd(c1, Simd::add(Simd::load(newest - (i + 1) + m), Simd::load(oldest + m + i + 1)), secondOdd);
+		}
+		if (i < taps) {
+			const Simd::Float c0 = Simd::set(coefficients[i]);
+			first = Simd::mulAdd(c0, Simd::add(Simd::load(newest - i + n), Simd::load(oldest + n + i)), first);
+			second = Simd::mulAdd(c0, Simd::add(Simd::load(newest - i + m), Simd::load(oldest + m + i)), second);
+		}
+		Simd::store(output + n, Simd::add(first, firstOdd));
+		Simd::store(output + m, Simd::add(second, secondOdd));
+	}
+	for (; n + Simd::width <= outputSize; n += Simd::width) {
+		Simd::Float sum = Simd::mul(Simd::set(0.5f), Simd::load(centre + n));
+		for (unsigned i = 0; i < taps; i++) {
+			sum = Simd::mulAdd(Simd::set(coefficients[i]), Simd::add(Simd::load(newest - i + n), Simd::load(oldest + n + i)), sum);
+		}
+		Simd::store(output + n, sum);
+	}
+	for (; n < outputSize; n++) {
+		float sum = 0.5f * centre[n];
+		for (unsigned i = 0; i < taps; i++) {
+			sum += coefficients[i] * (newest[(int)n - (int)i] + oldest[n + i]);
+		}
+		output[n] = sum;
+	}
+
+	// Keep the newest samples of each branch as the history of the next chunk
+	std::copy(even + outputSize, even + outputSize + stage.evenHistory, even);
+	std::copy(odd + outputSize, odd + outputSize + stage.oddHistory, odd);
+}
@@ -0,0 +1,104 @@
+#ifndef LOTKEY_CPP_JUCE_OVERSAMPLER_H
+#define LOTKEY_CPP_JUCE_OVERSAMPLER_H
+
+#include <vector>
+#include "Oscillators.h"
+
+/// <summary>
+/// Runs another oscillator at 2x, 4x or 8x the sample rate and decimates it back,
+/// for shapes and modulations that cannot be band-limited analytically.
+/// Decimation is a cascade of linear-phase half-band FIR stages, each halving the rate.
+/// Half of a half-band's taps are zero and the rest are symmetric, and split into even and
+/// odd polyphase branches only the outputs that are kept get computed, vectorised along time.
+/// Each stage is only as long as its own transition band needs: the early stages run at
+/// the high rates but have wide transitions and a handful of taps, while the long final
+/// stage runs at twice the output rate.
+/// The stages pass up to 0.42 of the output rate and reject what would alias into it by about 100 dB.
+/// Every buffer is allocated by the constructor.
+/// </summary>
+class Oscillators::Oversampler : public Oscillators::Oscillator {
+private:
+	/// <summary>
+	/// One 2:1 half-band decimator and its history
+	/// </summary>
+	struct Stage {
+		// Nonzero taps of one half, nearest the centre last; the centre tap is 0.5
+		std::vector<float> coefficients;
+		// Polyphase branches, each starting with the history the next chunk reads back into
+		std::vector<float> even;
+		std::vector<float> odd;
+		unsigned evenHistory = 0;
+		unsigned oddHistory = 0;
+	};
+
+	Oscillators::Oscillator* oscillator = nullptr;
+	unsigned factor = 2;
+	float sampleRate = 48000;
+	std::vector<Stage> stages;
+	std::vector<float> oversampled;
+	std::vector<float> frequencies;
+
+	void decimate(Stage& stage, const float* input, const unsigned& outputSize, float* output);
+	void decimateChunk(const unsigned& chunkSize, float* block);
+protected:
+	/// <summary>
+	/// Render the wrapped oscillator at the oversampled rate and decimate the next block
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Render the wrapped oscillator at the oversampled rate with a pitch per sample and decimate the next block.
+	/// Each pitch is held for the factor oversampled samples it covers.
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
+public:
+	/// <summary>
+	/// Samples rendered per chunk at the output rate
+	/// </summary>
+	static constexpr unsigned CHUNK_SIZE = 128;
+	/// <summary>
+	/// Constructor. The oscillator is not owned and must outlive the oversampler;
+	/// its sample rate is set to factor * sampleRate.
+	/// </summary>
+	/// <param name="oscillator"> - oscillator to run at the oversampled rate </param>
+	/// <param name="factor"> - oversampling factor: 2, 4 or 8 </param>
+	/// <param name="sampleRate"> - output sample rate (Hz) </param>
+	Oversampler(Oscillators::Oscillator& oscillator, const unsigned& factor, const float& sampleRate);
+	Oversampler(const Oversampler&) = delete;
+	Oversampler& operator=(const Oversampler&) = delete;
+	/// <summary>
+	/// Set the output sample rate; the wrapped oscillator runs at factor times it
+	/// </summary>
+	/// <param name="sampleRate"> - new output sample rate </param>
+	void setSampleRate(const float& sampleRate) override;
+	/// <summary>
+	/// Get the oversampling factor
+	/// </summary>
+	unsigned getFactor() const { return factor; }
+	/// <summary>
+	/// Get the delay the filters add, in output samples
+	/// </summary>
+	float getLatency() const;
+	/// <summary>
+	/// Clear the filter history, e.g. before reusing the oscillator for a new note
+	/// </summary>
+	void reset();
+	/// <summary>
+	/// Restart the phase of the wrapped oscillator. The filter history is kept, so the
+	/// jump is band-limited like any other edge.
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override;
+	/// <summary>
+	/// Switch the table of the wrapped oscillator, see Oscillator::changeTable
+	/// </summary>
+	/// <param name="mipMap"> - table to read, null to return to the oscillator's own </param>
+	void changeTable(const Oscillators::Wavetables::MipMap* mipMap) override;
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include <chrono>
+#include "Oscillators.h"
+#include "Simd.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+	uint64_t packRange(const uint32_t& begin, const uint32_t& end) {
+		return (uint64_t)begin | ((uint64_t)end << 32);
+	}
+
+	/// <summary>
+	/// Best effort: without the privilege the thread keeps its normal priority
+	/// </summary>
+	void setRealtimePriority(std::thread& thread) {
+#if defined(__linux__) || defined(__APPLE__)
+		sched_param parameters{};
+		parameters.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+		pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &parameters);
+#else
+		(void)thread;
+#endif
+	}
+
+	/// <summary>
+	/// Spin, then yield, then sleep: wakes fast inside a block without burning
+	/// a core while the engine is idle between blocks
+	/// </summary>
+	void backoff(unsigned& spins) {
+		if (spins < 64) {
+			spins++;
+		}
+		else if (spins < 4096) {
+			spins++;
+			std::this_thread::yield();
+		}
+		else {
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+	}
+};
+
+Oscillators::RenderEngine::RenderEngine(const unsigned& numThreads, const unsigned& maxBlockSize) {
+	this->numThreads = (numThreads == 0) ? 1 : numThreads;
+	this->maxBlockSize = maxBlockSize;
+	ranges = std::vector<WorkRange>(this->numThreads);
+
+	for (unsigned thread = 1; thread < this->numThreads; thread++) {
+		workers.emplace_back(&RenderEngine::workerLoop, this, thread);
+		setRealtimePriority(workers.back());
+	}
+}
+
+Oscillators::RenderEngine::~RenderEngine() {
+	running.store(false, std::memory_order_release);
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+unsigned Oscillators::RenderEngine::addVoice(Oscillators::Oscillator& oscillator) {
+	Voice voice;
+	voice.oscillator = &oscillator;
+	voices.push_back(voice);
+	partials.resize((size_t)getNumGroups() * maxBlockSize);
+	return (unsigned)voices.size() - 1;
+}
+
+void Oscillators::RenderEngine::setVoice(const unsigned& voice, const float& frequency, const float& gain) {
+	jassert(voice < voices.size());
+	voices[voice].frequency = frequency;
+	voices[voice].gain = gain;
+}
+
+void Oscillators::RenderEngine::process(const unsigned& blockSize, float* block) {
+	jassert(blockSize <= maxBlockSize);
+	const unsigned numGroups = getNumGroups();
+	if (numGroups == 0) {
+		for (unsigned i = 0; i < blockSize; i++) {
+			block[i] = 0.0f;
+		}
+		return;
+	}
+
+	// Publish the work: remaining before the ranges, so a thread that takes a group sees the right count
+	this->blockSize = blockSize;
+	remaining.store(numGroups, std::memory_order_relaxed);
+	for (unsigned thread = 0; thread < numThreads; thread++) {
+		uint32_t begin = (uint32_t)((uint64_t)numGroups * thread / numThreads);
+		uint32_t end = (uint32_t)((uint64_t)numGroups * (thread + 1) / numThreads);
+		ranges[thread].range.store(packRange(begin, end), std::memory_order_release);
+	}
+	generation.fetch_add(1, std::memory_order_release);
+
+	renderGroups(0);
+	while (remaining.load(std::memory_order_acquire) != 0) {
+		// Never sleep on the audio thread, the last groups are already being rendered
+		std::this_thread::yield();
+	}
+
+	// Mix in group order so the result does not depend on which thread rendered what
+	const float* partial = partials.data();
+	for (unsigned i = 0; i < blockSize; i++) {
+		block[i] = partial[i];
+	}
+	for (unsigned group = 1; group < numGroups; group++) {
+		partial = partials.data() + (size_t)group * maxBlockSize;
+		Simd::transform(blockSize, block, partial, [](const Simd::Float& sample, const Simd::Float& input) {
+			return Simd::add(sample, input);
+		});
+	}
+}
+
+void Oscillators::RenderEngine::workerLoop(const unsigned& thread) {
+	unsigned seen = generation.load(std::memory_order_acquire);
+	unsigned spins = 0;
+	while (running.load(std::memory_order_acquire)) {
+		unsigned current = generation.load(std::memory_order_acquire);
+		if (current == seen) {
+			backoff(spins);
+			continue;
+		}
+		seen = current;
+		spins = 0;
+		renderGroups(thread);
+	}
+}
+
+void Oscillators::RenderEngine::renderGroups(const unsigned& thread) {
+	unsigned group = 0;
+	while (takeGroup(thread, group)) {
+		renderGroup(group);
+		remaining.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+bool Oscillators::RenderEngine::takeGroup(const unsigned& thread, unsigned& group) {
+	// Own range first, from the front
+	std::atomic<uint64_t>& own = ranges[thread].range;
+	uint64_t range = own.load(std::memory_order_acquire);
+	while ((uint32_t)range < (uint32_t)(range >> 32)) {
+		uint32_t begin = (uint32_t)range;
+		if (own.compare_exchange_weak(range, packRange(begin + 1, (uint32_t)(range >> 32)), std::memory_order_acq_rel)) {
+			group = begin;
+			return true;
+		}
+	}
+
+	// Then steal from the back of the other threads' ranges
+	for (unsigned offset = 1; offset < numThreads; offset++) {
+		std::atomic<uint64_t>& victim = ranges[(thread + offset) % numThreads].range;
+		range = victim.load(std::memory_order_acquire);
+		while ((uint32_t)range < (uint32_t)(range >> 32)) {
+			uint32_t end = (uint32_t)(range >> 32);
+			if (victim.compare_exchange_weak(range, packRange((uint32_t)range, end - 1), std::memory_order_acq_rel)) {
+				group = end - 1;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void Oscillators::RenderEngine::renderGroup(const unsigned& group) {
+	float* partial = partials.data() + (size_t)group * maxBlockSize;
+	for (unsigned i = 0; i < blockSize; i++) {
+		partial[i] = 0.0f;
+	}
+
+	const unsigned first = group * VOICES_PER_GROUP;
+	const unsigned last = (first + VOICES_PER_GROUP < voices.size()) ? first + VOICES_PER_GROUP : (unsigned)voices.size();
+	for (unsigned voice = first; voice < last; voice++) {
+		voices[voice].oscillator->addBlock(voices[voice].frequency, blockSize, voices[voice].gain, partial);
+	}
+}
@@ -0,0 +1,96 @@
+#ifndef LOTKEY_CPP_JUCE_RENDERENGINE_H
+#define LOTKEY_CPP_JUCE_RENDERENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "Oscillators.h"
+
+/// <summary>
+/// Renders many oscillators across a fixed pool of worker threads.
+/// Voices are split into groups of VOICES_PER_GROUP. Every block the groups are
+/// dealt out to the threads, and a thread that runs out of groups steals from the
+/// back of another thread's range, so uneven voices (wavetable vs sine) balance out.
+/// Each group sums into its own buffer and the buffers are mixed in group order,
+/// so the output is bit-identical whatever the number of threads.
+/// The thread calling process takes part in the render.
+/// </summary>
+class Oscillators::RenderEngine {
+public:
+	/// <summary>
+	/// Number of voices rendered together as one unit of work
+	/// </summary>
+	static constexpr unsigned VOICES_PER_GROUP = 4;
+private:
+	struct Voice {
+		Oscillators::Oscillator* oscillator = nullptr;
+		float frequency = 0.0f;
+		float gain = 0.0f;
+	};
+	/// <summary>
+	/// Groups [begin, end) left to a thread, packed as begin | end << 32 so the owner
+	/// (taking from the front) and thieves (taking from the back) agree with one CAS
+	/// </summary>
+	struct alignas(64) WorkRange {
+		std::atomic<uint64_t> range{ 0 };
+	};
+
+	unsigned numThreads = 1;
+	unsigned maxBlockSize = 0;
+	std::vector<Voice> voices;
+	std::vector<float> partials;
+	std::vector<WorkRange> ranges;
+	std::vector<std::thread> workers;
+
+	unsigned blockSize = 0;
+	alignas(64) std::atomic<unsigned> generation{ 0 };
+	alignas(64) std::atomic<unsigned> remaining{ 0 };
+	std::atomic<bool> running{ true };
+
+	unsigned getNumGroups() const { return (unsigned)((voices.size() + VOICES_PER_GROUP - 1) / VOICES_PER_GROUP); }
+	void workerLoop(const unsigned& thread);
+	void renderGroups(const unsigned& thread);
+	bool takeGroup(const unsigned& thread, unsigned& group);
+	void renderGroup(const unsigned& group);
+public:
+	/// <summary>
+	/// Constructor. Starts numThreads - 1 workers at realtime priority where the OS allows it.
+	/// </summary>
+	/// <param name="numThreads"> - threads rendering each block, including the one calling process </param>
+	/// <param name="maxBlockSize"> - largest block size that will be processed </param>
+	RenderEngine(const unsigned& numThreads, const unsigned& maxBlockSize);
+	~RenderEngine();
+	RenderEngine(const RenderEngine&) = delete;
+	RenderEngine& operator=(const RenderEngine&) = delete;
+	/// <summary>
+	/// Add a voice. Allocates, so call off the audio thread while nothing is processing.
+	/// The oscillator is not owned and must outlive the engine.
+	/// </summary>
+	/// <param name="oscillator"> - oscillator rendering the voice </param>
+	/// <returns> index of the voice </returns>
+	unsigned addVoice(Oscillators::Oscillator& oscillator);
+	/// <summary>
+	/// Set the pitch and gain of a voice for the next blocks
+	/// </summary>
+	/// <param name="voice"> - index of the voice </param>
+	/// <param name="frequency"> - pitch (Hz) </param>
+	/// <param name="gain"> - gain of the voice in the mix </param>
+	void setVoice(const unsigned& voice, const float& frequency, const float& gain);
+	/// <summary>
+	/// Get the number of voices
+	/// </summary>
+	unsigned getNumVoices() const { return (unsigned)voices.size(); }
+	/// <summary>
+	/// Get the number of threads rendering each block
+	/// </summary>
+	unsigned getNumThreads() const { return numThreads; }
+	/// <summary>
+	/// Write the mix of every voice for the next block
+	/// </summary>
+	/// <param name="blockSize"> - size of the block to write, at most maxBlockSize </param>
+	/// <param name="block"> - float* to write to </param>
+	void process(const unsigned& blockSize, float* block);
+};
+
+#endif
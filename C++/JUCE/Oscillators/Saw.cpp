@@ -1,55 +1,78 @@
 #include <cmath>
-#include "SawOscillator.h"
+#include "Saw.h"
+#include "Simd.h"
+
+namespace {
+	using namespace Oscillators;
+
+	Simd::Float antialiased(const Simd::Float& phases, const Simd::Float& dt, const Simd::Float& inverseDt) {
+		return Simd::sub(Simd::saw(phases), Simd::polyBlep(phases, dt, inverseDt));
+	}
+};
 
 void Oscillators::Saw::updateAngleDelta(const double& frequency) {
-	double cyclesPerSample = frequency / sampleRate;
-	angleDelta = cyclesPerSample * 2.0;
+	phase.setFrequency(frequency, sampleRate);
 }
 
 Oscillators::Saw::Saw(const float& sampleRate) {
 	this->sampleRate = sampleRate;
 }
 
+Oscillators::Saw::Saw(const float& sampleRate, const Oscillators::Antialiasing& antialiasing) {
+	this->sampleRate = sampleRate;
+	this->antialiasing = antialiasing;
+}
+
+void Oscillators::Saw::setAntialiasing(const Oscillators::Antialiasing& antialiasing) {
+	this->antialiasing = antialiasing;
+}
+
 void Oscillators::Saw::setSampleRate(const float& sampleRate) {
 	this->sampleRate = sampleRate;
 }
 
-float* Oscillators::Saw::getBlock(const float& frequency, const unsigned& blockSize) {
-	updateAngleDelta(frequency);
-	float* block = new float[blockSize];
-	for (unsigned i = 0; i < blockSize; i++) {
-		block[i] = std::fmod(currentAngle, 2.0f) - 1.0f;
-		currentAngle += angleDelta;
-	}
-	return block;
+void Oscillators::Saw::resetPhase(const double& cycles) {
+	phase.reset(cycles);
 }
 
-float* Oscillators::Saw::getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude) {
+void Oscillators::Saw::render(const float& frequency, const unsigned& blockSize, float* block) {
 	updateAngleDelta(frequency);
-	float* block = new float[blockSize];
-	for (unsigned i = 0; i < blockSize; i++) {
-		block[i] = std::fmod(currentAngle, 2.0f) - 1.0f;
-		block[i] *= amplitude;
-		currentAngle += angleDelta;
+	phase.fill(blockSize, block);
+
+	if (antialiasing == Oscillators::Antialiasing::POLYBLEP) {
+		// The width of the correction is the distance moved per sample, whichever way the phase runs.
+		// A zero increment makes inverseDt infinite, but then neither polynomial branch is selected
+		const float increment = std::fabs(frequency) / sampleRate;
+		const Simd::Float dt = Simd::set(increment);
+		const Simd::Float inverseDt = Simd::set(1.0f / increment);
+		Simd::transform(blockSize, block, [&](const Simd::Float& phases) { return antialiased(phases, dt, inverseDt); });
+	}
+	else {
+		Simd::transform(blockSize, block, [](const Simd::Float& phases) { return Simd::saw(phases); });
 	}
-	return block;
 }
 
-float* Oscillators::Saw::writeBlock(const float& frequency, const unsigned& blockSize, const float* block) {
-	updateAngleDelta(frequency);
-	for (unsigned i = 0; i < blockSize; i++) {
-		block[i] = std::fmod(currentAngle, 2.0f) - 1.0f;
-		currentAngle += angleDelta;
-	}
-	return block;
+void Oscillators::Saw::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	phase.fill(frequencies, sampleRate, blockSize, block);
+	shape(frequencies, blockSize, block);
 }
 
-float* Oscillators::Saw::writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) {
-	updateAngleDelta(frequency);
-	for (unsigned i = 0; i < blockSize; i++) {
-		block[i] = std::fmod(currentAngle, 2.0f) - 1.0f;
-		block[i] *= amplitude;
-		currentAngle += angleDelta;
+void Oscillators::Saw::renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points) {
+	// Each point moves the phase on by stride samples at its pitch
+	phase.fill(frequencies, (double)sampleRate / stride, numPoints, points);
+	shape(frequencies, numPoints, points);
+}
+
+void Oscillators::Saw::shape(const float* frequencies, const unsigned& blockSize, float* block) {
+	if (antialiasing == Oscillators::Antialiasing::POLYBLEP) {
+		const Simd::Float inverseSampleRate = Simd::set(1.0f / sampleRate);
+		Simd::transform(blockSize, block, frequencies, [&](const Simd::Float& phases, const Simd::Float& frequency) {
+			// A zero increment makes inverseDt infinite, but then neither polynomial branch is selected
+			Simd::Float dt = Simd::mul(Simd::abs(frequency), inverseSampleRate);
+			return antialiased(phases, dt, Simd::div(Simd::set(1.0f), dt));
+		});
+	}
+	else {
+		Simd::transform(blockSize, block, [](const Simd::Float& phases) { return Simd::saw(phases); });
 	}
-	return block;
 }
\ No newline at end of file
@@ -9,10 +9,34 @@
 class Oscillators::Saw : public Oscillators::Oscillator {
 private:
 	float sampleRate = 48000;
-	double angleDelta = 0.0f;
-	double currentAngle = 0.0f;
+	Oscillators::PhaseAccumulator phase;
+	Oscillators::Antialiasing antialiasing = Oscillators::Antialiasing::NONE;
 
-	void updateAngleDelta(const double& frequency) override;
+	void updateAngleDelta(const double& frequency);
+	void shape(const float* frequencies, const unsigned& blockSize, float* block);
+protected:
+	/// <summary>
+	/// Render the next block at unit amplitude
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Render the next block at unit amplitude with a pitch per sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Write every stride-th sample in one pass, each band-limited for its own pitch
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each point </param>
+	/// <param name="stride"> - samples from one point to the next </param>
+	/// <param name="numPoints"> - number of points to write </param>
+	/// <param name="points"> - float* to write to </param>
+	void renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points) override;
 public:
 	/// <summary>
 	/// Default constructor
@@ -24,40 +48,27 @@ public:
 	/// <param name="sampleRate"> - sample rate (Hz) </param>
 	Saw(const float& sampleRate);
 	/// <summary>
+	/// Constructor from sample rate and anti-aliasing mode
+	/// </summary>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	/// <param name="antialiasing"> - anti-aliasing mode, see setAntialiasing </param>
+	Saw(const float& sampleRate, const Oscillators::Antialiasing& antialiasing);
+	/// <summary>
 	/// Set the sample rate of the oscillator
 	/// </summary>
 	/// <param name="sampleRate"> - new sample rate </param>
 	void setSampleRate(const float& sampleRate) override;
 	/// <summary>
-	/// Get the next block from the oscillator
+	/// Restart the phase
 	/// </summary>
-	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to return </param>
-	/// <returns> block as a float* </returns>
-	float* getBlock(const float& frequency, const unsigned& blockSize) override;
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override;
 	/// <summary>
-	/// Get the next block from the oscillator
+	/// Set the anti-aliasing mode. POLYBLEP applies PolyBLEP at the wrap,
+	/// which removes most aliasing at high pitches for a few extra operations per sample.
 	/// </summary>
-	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to return </param>
-	/// <param name="amplitude"> - amplitude of the block to return </param>
-	/// <returns> block as a float* </returns>
-	float* getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude) override;
-	/// <summary>
-	/// Write the next block with the oscillator
-	/// </summary>
-	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to write </param>
-	/// <param name="block"> - float* to write to </param>
-	virtual void writeBlock(const float& frequency, const unsigned& blockSize, const float* block) override;
-	/// <summary>
-	/// Write the next block with the oscillator
-	/// </summary>
-	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to write </param>
-	/// <param name="amplitude"> - amplitude of the block to write </param>
-	/// <param name="block"> - float* to write to </param>
-	virtual void writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) override;
+	/// <param name="antialiasing"> - new anti-aliasing mode </param>
+	void setAntialiasing(const Oscillators::Antialiasing& antialiasing);
 };
 
 #endif
\ No newline at end of file
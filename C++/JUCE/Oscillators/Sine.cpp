@@ -1,5 +1,11 @@
 #include <cmath>
-#include "SineOscillator.h"
+#include "Sine.h"
+#include "Simd.h"
+
+namespace {
+    constexpr unsigned PHASOR_LANES = 8;
+    constexpr unsigned PHASOR_RESYNC = 1024;
+};
 
 void Oscillators::Sine::updateAngleDelta(const double& frequency) {
     double cyclesPerSample = frequency / sampleRate;
@@ -10,45 +16,168 @@ Oscillators::Sine::Sine(const float& sampleRate) {
     this->sampleRate = sampleRate;
 }
 
+Oscillators::Sine::Sine(const float& sampleRate, const Oscillators::Accuracy& accuracy) {
+    this->sampleRate = sampleRate;
+    this->accuracy = accuracy;
+}
+
+void Oscillators::Sine::setAccuracy(const Oscillators::Accuracy& accuracy) {
+    this->accuracy = accuracy;
+}
+
 void Oscillators::Sine::setSampleRate(const float& sampleRate) {
     this->sampleRate = sampleRate;
 }
 
-float* Oscillators::Sine::getBlock(const float& frequency, const unsigned& blockSize) {
+void Oscillators::Sine::resetPhase(const double& cycles) {
+    currentAngle = 2.0 * PI * (cycles - std::floor(cycles));
+}
+
+void Oscillators::Sine::render(const float& frequency, const unsigned& blockSize, float* block) {
     updateAngleDelta(frequency);
-    float* block = new float[blockSize];
+    switch (accuracy) {
+    case(Oscillators::Accuracy::MINUS_120_DB):
+        renderPolynomial(blockSize, block);
+        return;
+    case(Oscillators::Accuracy::MINUS_90_DB):
+        renderPhasor(blockSize, block);
+        return;
+    default:
+        break;
+    }
+
     for (unsigned i = 0; i < blockSize; i++) {
         block[i] = (float)std::sin(currentAngle);
         currentAngle += angleDelta;
     }
-    return block;
 }
 
-float* Oscillators::Sine::getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude) {
-    updateAngleDelta(frequency);
-    float* block = new float[blockSize];
-    for (unsigned i = 0; i < blockSize; i++) {
-        block[i] = (float)std::sin(currentAngle) * amplitude;
-        currentAngle += angleDelta;
+void Oscillators::Sine::renderPolynomial(const unsigned& blockSize, float* block) {
+    // Work in cycles so the polynomial sees a phase in [0, 1)
+    const double twoPi = 2.0 * PI;
+    const double delta = angleDelta / twoPi;
+    double phase = std::fmod(currentAngle, twoPi) / twoPi;
+    if (phase < 0.0) {
+        phase += 1.0;
+    }
+
+    float ramp[Simd::width];
+    for (unsigned i = 0; i < Simd::width; i++) {
+        ramp[i] = (float)(i * delta);
     }
-    return block;
+    const Simd::Float offsets = Simd::load(ramp);
+
+    unsigned i = 0;
+    for (; i + Simd::width <= blockSize; i += Simd::width) {
+        Simd::Float phases = Simd::wrap(Simd::add(Simd::set((float)phase), offsets));
+        Simd::store(block + i, Simd::sine(phases));
+        phase += Simd::width * delta;
+        phase -= std::floor(phase);
+    }
+    if (i < blockSize) {
+        float tail[Simd::width];
+        Simd::store(tail, Simd::sine(Simd::wrap(Simd::add(Simd::set((float)phase), offsets))));
+        for (unsigned j = 0; i + j < blockSize; j++) {
+            block[i + j] = tail[j];
+        }
+        phase += (blockSize - i) * delta;
+        phase -= std::floor(phase);
+    }
+
+    currentAngle = phase * twoPi;
 }
 
-float* Oscillators::Sine::writeBlock(const float& frequency, const unsigned& blockSize, const float* block) {
-    updateAngleDelta(frequency);
-    for (unsigned i = 0; i < blockSize; i++) {
-        block[i] = (float)std::sin(currentAngle);
-        currentAngle += angleDelta;
+void Oscillators::Sine::renderPhasor(const unsigned& blockSize, float* block) {
+    // Each lane rotates by PHASOR_LANES samples per step, so the inner loops have
+    // no dependency between lanes and vectorize
+    const float stepCos = (float)std::cos(PHASOR_LANES * angleDelta);
+    const float stepSin = (float)std::sin(PHASOR_LANES * angleDelta);
+    const double laneCos = std::cos(angleDelta);
+    const double laneSin = std::sin(angleDelta);
+
+    for (unsigned start = 0; start < blockSize; start += PHASOR_RESYNC) {
+        const unsigned count = (blockSize - start < PHASOR_RESYNC) ? blockSize - start : PHASOR_RESYNC;
+
+        // Re-anchor to the exact phase, which also renormalizes the magnitude
+        float re[PHASOR_LANES], im[PHASOR_LANES];
+        double c = std::cos(currentAngle), s = std::sin(currentAngle);
+        for (unsigned k = 0; k < PHASOR_LANES; k++) {
+            re[k] = (float)c;
+            im[k] = (float)s;
+            double next = c * laneCos - s * laneSin;
+            s = s * laneCos + c * laneSin;
+            c = next;
+        }
+
+        float* out = block + start;
+        unsigned i = 0;
+        for (; i + PHASOR_LANES <= count; i += PHASOR_LANES) {
+            for (unsigned k = 0; k < PHASOR_LANES; k++) {
+                out[i + k] = im[k];
+            }
+            for (unsigned k = 0; k < PHASOR_LANES; k++) {
+                float next = re[k] * stepCos - im[k] * stepSin;
+                im[k] = im[k] * stepCos + re[k] * stepSin;
+                re[k] = next;
+            }
+        }
+        for (unsigned k = 0; i + k < count; k++) {
+            out[i + k] = im[k];
+        }
+
+        currentAngle = std::fmod(currentAngle + count * angleDelta, 2.0 * PI);
     }
-    return block;
 }
 
-float* Oscillators::Sine::writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) {
-    updateAngleDelta(frequency);
+void Oscillators::Sine::render(const float* frequencies, const unsigned& blockSize, float* block) {
+    if (accuracy == Oscillators::Accuracy::BIT_ACCURATE) {
+        const double angleScale = 2.0 * PI / sampleRate;
+        for (unsigned i = 0; i < blockSize; i++) {
+            block[i] = (float)std::sin(currentAngle);
+            currentAngle += frequencies[i] * angleScale;
+        }
+        return;
+    }
+
+    // Accumulate the phase in cycles, then shape the whole block with the polynomial
+    const double twoPi = 2.0 * PI;
+    const double cycleScale = 1.0 / sampleRate;
+    double phase = std::fmod(currentAngle, twoPi) / twoPi;
+    if (phase < 0.0) {
+        phase += 1.0;
+    }
     for (unsigned i = 0; i < blockSize; i++) {
-        block[i] = (float)std::sin(currentAngle);
-        block[i] *= amplitude;
-        currentAngle += angleDelta;
+        block[i] = (float)phase;
+        phase += frequencies[i] * cycleScale;
+        if (phase >= 1.0) {
+            phase -= 1.0;
+        }
+        else if (phase < 0.0) {
+            phase += 1.0;
+        }
+    }
+    Simd::transform(blockSize, block, [](const Simd::Float& phases) { return Simd::sine(Simd::wrap(phases)); });
+
+    currentAngle = phase * twoPi;
+}
+
+void Oscillators::Sine::renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points) {
+    // Each point moves the phase on by stride samples, which may be more than a cycle
+    const double twoPi = 2.0 * PI;
+    const double cycleScale = (double)stride / sampleRate;
+    double phase = std::fmod(currentAngle, twoPi) / twoPi;
+    if (phase < 0.0) {
+        phase += 1.0;
+    }
+    const bool exact = (accuracy == Oscillators::Accuracy::BIT_ACCURATE);
+    for (unsigned i = 0; i < numPoints; i++) {
+        points[i] = exact ? (float)std::sin(phase * twoPi) : (float)phase;
+        phase += frequencies[i] * cycleScale;
+        phase -= std::floor(phase);
     }
-    return block;
+    if (!exact) {
+        Simd::transform(numPoints, points, [](const Simd::Float& phases) { return Simd::sine(Simd::wrap(phases)); });
+    }
+
+    currentAngle = phase * twoPi;
 }
\ No newline at end of file
@@ -11,8 +11,35 @@ private:
 	float sampleRate = 48000;
 	double angleDelta = 0.0f;
 	double currentAngle = 0.0f;
+	Oscillators::Accuracy accuracy = Oscillators::Accuracy::BIT_ACCURATE;
 
-	void updateAngleDelta(const double& frequency) override;
+	void updateAngleDelta(const double& frequency);
+	void renderPolynomial(const unsigned& blockSize, float* block);
+	void renderPhasor(const unsigned& blockSize, float* block);
+protected:
+	/// <summary>
+	/// Render the next block at unit amplitude
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Render the next block at unit amplitude with a pitch per sample.
+	/// MINUS_90_DB falls back to the polynomial, since the phasor needs a fixed rotation.
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Write every stride-th sample in one pass, at the accuracy of the block paths
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each point </param>
+	/// <param name="stride"> - samples from one point to the next </param>
+	/// <param name="numPoints"> - number of points to write </param>
+	/// <param name="points"> - float* to write to </param>
+	void renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points) override;
 public:
 	/// <summary>
 	/// Default constructor
@@ -24,40 +51,36 @@ public:
 	/// <param name="sampleRate"> - sample rate (Hz) </param>
 	Sine(const float& sampleRate);
 	/// <summary>
+	/// Constructor from sample rate and accuracy
+	/// </summary>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	/// <param name="accuracy"> - render accuracy, see setAccuracy </param>
+	Sine(const float& sampleRate, const Oscillators::Accuracy& accuracy);
+	/// <summary>
 	/// Set the sample rate of the oscillator
 	/// </summary>
 	/// <param name="sampleRate"> - new sample rate </param>
 	void setSampleRate(const float& sampleRate) override;
 	/// <summary>
-	/// Get the next block from the oscillator
-	/// </summary>
-	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to return </param>
-	/// <returns> block as a float* </returns>
-	float* getBlock(const float& frequency, const unsigned& blockSize) override;
-	/// <summary>
-	/// Get the next block from the oscillator
+	/// Restart the phase
 	/// </summary>
-	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to return </param>
-	/// <param name="amplitude"> - amplitude of the block to return </param>
-	/// <returns> block as a float* </returns>
-	float* getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude) override;
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override;
 	/// <summary>
-	/// Write the next block with the oscillator
+	/// Set the render accuracy.
+	/// BIT_ACCURATE calls std::sin in double per sample (the reference output).
+	/// MINUS_120_DB evaluates Simd::sine, a 9th order minimax polynomial, on the wrapped phase
+	/// Simd::width samples at a time. Rounding the phase to float adds to the polynomial's
+	/// own error: max error 6.7e-7 (-123 dB) against the double reference, SNR above 133 dB.
+	/// MINUS_90_DB runs 8 interleaved rotating phasors re-anchored to the exact phase
+	/// every 1024 samples: max error 4.0e-6 (-108 dB), SNR above 113 dB.
 	/// </summary>
-	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to write </param>
-	/// <param name="block"> - float* to write to </param>
-	virtual void writeBlock(const float& frequency, const unsigned& blockSize, const float* block) override;
+	/// <param name="accuracy"> - new accuracy </param>
+	void setAccuracy(const Oscillators::Accuracy& accuracy);
 	/// <summary>
-	/// Write the next block with the oscillator
+	/// Get the render accuracy
 	/// </summary>
-	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
-	/// <param name="blockSize"> - size of the block to write </param>
-	/// <param name="amplitude"> - amplitude of the block to write </param>
-	/// <param name="block"> - float* to write to </param>
-	virtual void writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) override;
+	Oscillators::Accuracy getAccuracy() const { return accuracy; }
 };
 
 #endif
\ No newline at end of file
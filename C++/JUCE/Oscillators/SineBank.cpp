@@ -0,0 +1,133 @@
+#include <cmath>
+#include "SineBank.h"
+#include "Simd.h"
+
+namespace {
+	// Samples rendered between rebuilding the phasors from the exact phases
+	constexpr unsigned CHUNK = 64;
+};
+
+Oscillators::SineBank::SineBank(const float& sampleRate, const unsigned& numPartials) {
+	this->sampleRate = sampleRate;
+	for (unsigned k = 0; k < MAX_PARTIALS; k++) {
+		ratios[k] = (float)(k + 1);
+	}
+	amplitudes[0] = 1.0f;
+	setNumPartials(numPartials);
+	resetPhase(0.0);
+}
+
+void Oscillators::SineBank::setSampleRate(const float& sampleRate) {
+	this->sampleRate = sampleRate;
+}
+
+void Oscillators::SineBank::setNumPartials(const unsigned& numPartials) {
+	jassert(numPartials >= 1 && numPartials <= MAX_PARTIALS);
+	this->numPartials = (numPartials < 1) ? 1 : (numPartials > MAX_PARTIALS) ? MAX_PARTIALS : numPartials;
+}
+
+void Oscillators::SineBank::setPartial(const unsigned& index, const float& ratio, const float& amplitude) {
+	if (index >= numPartials) {
+		jassertfalse;
+		return;
+	}
+	ratios[index] = ratio;
+	amplitudes[index] = amplitude;
+}
+
+void Oscillators::SineBank::setAmplitude(const unsigned& index, const float& amplitude) {
+	if (index >= numPartials) {
+		jassertfalse;
+		return;
+	}
+	amplitudes[index] = amplitude;
+}
+
+void Oscillators::SineBank::setHarmonics(const std::vector<float>& amplitudes, const std::vector<float>& phases) {
+	setNumPartials((unsigned)amplitudes.size());
+	for (unsigned k = 0; k < numPartials; k++) {
+		ratios[k] = (float)(k + 1);
+		this->amplitudes[k] = (k < amplitudes.size()) ? amplitudes[k] : 0.0f;
+		const double phase = (k < phases.size()) ? phases[k] / (2.0 * PI) : 0.0;
+		startPhases[k] = (float)(phase - std::floor(phase));
+	}
+	resetPhase(0.0);
+}
+
+void Oscillators::SineBank::resetPhase(const double& cycles) {
+	for (unsigned k = 0; k < MAX_PARTIALS; k++) {
+		const double phase = ratios[k] * cycles + startPhases[k];
+		phases[k] = phase - std::floor(phase);
+	}
+}
+
+unsigned Oscillators::SineBank::startChunk(const double& frequency, const double& cycles) {
+	const double delta = frequency / sampleRate;
+	unsigned numActive = 0;
+	// Stage phase, increment and amplitude in the arrays the vector pass turns into phasors
+	for (unsigned k = 0; k < numPartials; k++) {
+		const double partialDelta = ratios[k] * delta;
+		const bool audible = std::fabs(partialDelta) < 0.5 && amplitudes[k] != 0.0f;
+		sines[k] = (float)phases[k];
+		stepSines[k] = (float)(partialDelta - std::floor(partialDelta));
+		cosines[k] = audible ? amplitudes[k] : 0.0f;
+		numActive = audible ? k + 1 : numActive;
+
+		const double phase = phases[k] + ratios[k] * cycles;
+		phases[k] = phase - std::floor(phase);
+	}
+	const unsigned padded = (numActive + Simd::width - 1) / Simd::width * Simd::width;
+	for (unsigned k = numActive; k < padded; k++) {
+		cosines[k] = 0.0f;
+		sines[k] = 0.0f;
+		stepSines[k] = 0.0f;
+	}
+
+	const Simd::Float quarter = Simd::set(0.25f);
+	for (unsigned k = 0; k < padded; k += Simd::width) {
+		const Simd::Float phase = Simd::load(sines + k);
+		const Simd::Float step = Simd::load(stepSines + k);
+		const Simd::Float amplitude = Simd::load(cosines + k);
+		Simd::store(sines + k, Simd::mul(amplitude, Simd::sine(Simd::wrap(phase))));
+		Simd::store(cosines + k, Simd::mul(amplitude, Simd::sine(Simd::wrap(Simd::add(phase, quarter)))));
+		Simd::store(stepSines + k, Simd::sine(Simd::wrap(step)));
+		Simd::store(stepCosines + k, Simd::sine(Simd::wrap(Simd::add(step, quarter))));
+	}
+	return padded;
+}
+
+void Oscillators::SineBank::renderChunk(const unsigned& numActive, const unsigned& blockSize, float* block) {
+	for (unsigned i = 0; i < blockSize; i++) {
+		Simd::Float sum = Simd::set(0.0f);
+		for (unsigned k = 0; k < numActive; k += Simd::width) {
+			const Simd::Float c = Simd::load(cosines + k);
+			const Simd::Float s = Simd::load(sines + k);
+			const Simd::Float stepC = Simd::load(stepCosines + k);
+			const Simd::Float stepS = Simd::load(stepSines + k);
+			sum = Simd::add(sum, s);
+			Simd::store(cosines + k, Simd::sub(Simd::mul(c, stepC), Simd::mul(s, stepS)));
+			Simd::store(sines + k, Simd::mulAdd(c, stepS, Simd::mul(s, stepC)));
+		}
+		block[i] = Simd::sum(sum);
+	}
+}
+
+void Oscillators::SineBank::render(const float& frequency, const unsigned& blockSize, float* block) {
+	for (unsigned start = 0; start < blockSize; start += CHUNK) {
+		const unsigned count = (blockSize - start < CHUNK) ? blockSize - start : CHUNK;
+		const unsigned numActive = startChunk(frequency, (double)frequency * count / sampleRate);
+		renderChunk(numActive, count, block + start);
+	}
+}
+
+void Oscillators::SineBank::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	for (unsigned start = 0; start < blockSize; start += CHUNK) {
+		const unsigned count = (blockSize - start < CHUNK) ? blockSize - start : CHUNK;
+		double total = 0.0;
+		for (unsigned i = 0; i < count; i++) {
+			total += frequencies[start + i];
+		}
+		const unsigned numActive = startChunk(total / count, total / sampleRate);
+		renderChunk(numActive, count, block + start);
+	}
+}
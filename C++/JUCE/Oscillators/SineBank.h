@@ -0,0 +1,107 @@
+#ifndef LOTKEY_CPP_JUCE_SINEBANK_H
+#define LOTKEY_CPP_JUCE_SINEBANK_H
+
+#include <vector>
+#include "Oscillators.h"
+
+/// <summary>
+/// Additive oscillator: up to MAX_PARTIALS sine partials, each at a ratio of one pitch.
+/// Every partial is a recursive quadrature oscillator (a rotating phasor, two multiplies and
+/// two multiply-adds per sample) and Simd::width partials rotate at once, so no partial ever
+/// evaluates a sine per sample. The phasors are rebuilt from each partial's exact phase every
+/// 64 samples, which keeps the rounding of the recursion from building up: the error stays
+/// around -90 dB of the peak, the MINUS_90_DB tier of Sine.
+/// Partials at or above Nyquist are muted, and partials past the last audible one cost nothing,
+/// so keep them sorted by ratio. With a pitch per sample, each 64-sample chunk runs at the mean
+/// pitch of the chunk and lands on the exact phase at its end.
+/// Nothing allocates: every partial lives in fixed arrays of MAX_PARTIALS.
+/// </summary>
+class Oscillators::SineBank : public Oscillators::Oscillator {
+public:
+	/// <summary>
+	/// Largest number of partials
+	/// </summary>
+	static constexpr unsigned MAX_PARTIALS = 512;
+private:
+	float sampleRate = 48000;
+	unsigned numPartials = 1;
+
+	float ratios[MAX_PARTIALS] = {};
+	float amplitudes[MAX_PARTIALS] = {};
+	// Phase (cycles) each partial restarts at
+	float startPhases[MAX_PARTIALS] = {};
+	// Exact phase (cycles) of each partial at the start of the next chunk
+	double phases[MAX_PARTIALS] = {};
+
+	// Phasors of the chunk being rendered, scaled by amplitude, and their rotation per sample
+	alignas(64) float cosines[MAX_PARTIALS] = {};
+	alignas(64) float sines[MAX_PARTIALS] = {};
+	alignas(64) float stepCosines[MAX_PARTIALS] = {};
+	alignas(64) float stepSines[MAX_PARTIALS] = {};
+
+	unsigned startChunk(const double& frequency, const double& cycles);
+	void renderChunk(const unsigned& numActive, const unsigned& blockSize, float* block);
+protected:
+	/// <summary>
+	/// Render the sum of the partials for the next block
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Render the sum of the partials for the next block with a pitch per sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
+public:
+	/// <summary>
+	/// Constructor. Partial k starts as harmonic k + 1; only the fundamental is audible.
+	/// </summary>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	/// <param name="numPartials"> - number of partials, 1 to MAX_PARTIALS </param>
+	SineBank(const float& sampleRate, const unsigned& numPartials = 1);
+	/// <summary>
+	/// Set the sample rate of the oscillator
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) override;
+	/// <summary>
+	/// Set the number of partials. Partials keep their settings and phases.
+	/// </summary>
+	/// <param name="numPartials"> - number of partials, 1 to MAX_PARTIALS </param>
+	void setNumPartials(const unsigned& numPartials);
+	/// <summary>
+	/// Get the number of partials
+	/// </summary>
+	unsigned getNumPartials() const { return numPartials; }
+	/// <summary>
+	/// Set one partial
+	/// </summary>
+	/// <param name="index"> - partial, below getNumPartials </param>
+	/// <param name="ratio"> - frequency as a multiple of the pitch </param>
+	/// <param name="amplitude"> - amplitude </param>
+	void setPartial(const unsigned& index, const float& ratio, const float& amplitude);
+	/// <summary>
+	/// Set the amplitude of one partial
+	/// </summary>
+	/// <param name="index"> - partial, below getNumPartials </param>
+	/// <param name="amplitude"> - amplitude </param>
+	void setAmplitude(const unsigned& index, const float& amplitude);
+	/// <summary>
+	/// Make the partials a harmonic series, with the same spectrum as
+	/// Wavetables::fromHarmonics, and restart them at their phases
+	/// </summary>
+	/// <param name="amplitudes"> - amplitude of each harmonic, from the fundamental up; sets the number of partials </param>
+	/// <param name="phases"> - phase (radians) of each harmonic; missing entries are 0 </param>
+	void setHarmonics(const std::vector<float>& amplitudes, const std::vector<float>& phases);
+	/// <summary>
+	/// Restart every partial at ratio * cycles plus its own phase from setHarmonics
+	/// </summary>
+	/// <param name="cycles"> - phase of the fundamental to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override;
+};
+
+#endif
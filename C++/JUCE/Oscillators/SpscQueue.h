@@ -0,0 +1,54 @@
+#ifndef LOTKEY_CPP_JUCE_SPSCQUEUE_H
+#define LOTKEY_CPP_JUCE_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include "Oscillators.h"
+
+/// <summary>
+/// Bounded lock-free queue for one producer thread and one consumer thread.
+/// push and pop are wait-free and never allocate, so either side may be the audio thread.
+/// </summary>
+/// <typeparam name="T"> - trivially copyable element </typeparam>
+/// <typeparam name="Capacity"> - number of slots, a power of two </typeparam>
+template <typename T, size_t Capacity>
+class Oscillators::SpscQueue {
+private:
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	T slots[Capacity];
+	// Free-running counters; the slot is the counter masked by Capacity - 1
+	alignas(64) std::atomic<size_t> head{ 0 };
+	alignas(64) std::atomic<size_t> tail{ 0 };
+public:
+	/// <summary>
+	/// Add an element. Producer thread only.
+	/// </summary>
+	/// <param name="value"> - element to add </param>
+	/// <returns> false if the queue is full </returns>
+	bool push(const T& value) {
+		const size_t current = tail.load(std::memory_order_relaxed);
+		if (current - head.load(std::memory_order_acquire) == Capacity) {
+			return false;
+		}
+		slots[current & (Capacity - 1)] = value;
+		tail.store(current + 1, std::memory_order_release);
+		return true;
+	}
+	/// <summary>
+	/// Remove the oldest element. Consumer thread only.
+	/// </summary>
+	/// <param name="value"> - receives the element </param>
+	/// <returns> false if the queue is empty </returns>
+	bool pop(T& value) {
+		const size_t current = head.load(std::memory_order_relaxed);
+		if (current == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		value = slots[current & (Capacity - 1)];
+		head.store(current + 1, std::memory_order_release);
+		return true;
+	}
+};
+
+#endif
@@ -1,57 +1,79 @@
 #include <cmath>
-#include "SquareOscillator.h"
+#include "Square.h"
+#include "Simd.h"
+
+namespace {
+	using namespace Oscillators;
+
+	Simd::Float antialiased(const Simd::Float& phases, const Simd::Float& dt, const Simd::Float& inverseDt) {
+		Simd::Float opposite = Simd::wrap(Simd::add(phases, Simd::set(0.5f)));
+		return Simd::add(Simd::sub(Simd::square(phases), Simd::polyBlep(phases, dt, inverseDt)), Simd::polyBlep(opposite, dt, inverseDt));
+	}
+};
 
 void Oscillators::Square::updateAngleDelta(const double& frequency) {
-	double cyclesPerSample = frequency / sampleRate;
-	angleDelta = cyclesPerSample * 2.0;
+	phase.setFrequency(frequency, sampleRate);
 }
 
 Oscillators::Square::Square(const float& sampleRate) {
 	this->sampleRate = sampleRate;
 }
 
+Oscillators::Square::Square(const float& sampleRate, const Oscillators::Antialiasing& antialiasing) {
+	this->sampleRate = sampleRate;
+	this->antialiasing = antialiasing;
+}
+
+void Oscillators::Square::setAntialiasing(const Oscillators::Antialiasing& antialiasing) {
+	this->antialiasing = antialiasing;
+}
+
 void Oscillators::Square::setSampleRate(const float& sampleRate) {
 	this->sampleRate = sampleRate;
 }
 
-float* Oscillators::Square::getBlock(const float& frequency, const unsigned& blockSize) {
-	updateAngleDelta(frequency);
-	float* block = new float[blockSize];
-	for (unsigned i = 0; i < blockSize; i++) {
-		float angleMod = std::fmod(currentAngle, 2.0f) - 1.0f;
-		block[i] = (angleMod < 0) ? -1.0f : 1.0f;
-		currentAngle += angleDelta;
-	}
-	return block;
+void Oscillators::Square::resetPhase(const double& cycles) {
+	phase.reset(cycles);
 }
 
-float* Oscillators::Square::getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude) {
+void Oscillators::Square::render(const float& frequency, const unsigned& blockSize, float* block) {
 	updateAngleDelta(frequency);
-	float* block = new float[blockSize];
-	for (unsigned i = 0; i < blockSize; i++) {
-		float angleMod = std::fmod(currentAngle, 2.0f) - 1.0f;
-		block[i] = (angleMod < 0) ? -1.0f : 1.0f;
-		block[i] *= amplitude;
-		currentAngle += angleDelta;
+	phase.fill(blockSize, block);
+
+	if (antialiasing == Oscillators::Antialiasing::POLYBLEP) {
+		// The width of the correction is the distance moved per sample, whichever way the phase runs.
+		// A zero increment makes inverseDt infinite, but then neither polynomial branch is selected
+		const float increment = std::fabs(frequency) / sampleRate;
+		const Simd::Float dt = Simd::set(increment);
+		const Simd::Float inverseDt = Simd::set(1.0f / increment);
+		Simd::transform(blockSize, block, [&](const Simd::Float& phases) { return antialiased(phases, dt, inverseDt); });
+	}
+	else {
+		Simd::transform(blockSize, block, [](const Simd::Float& phases) { return Simd::square(phases); });
 	}
-	return block;
 }
 
-float* Oscillators::Square::writeBlock(const float& frequency, const unsigned& blockSize, const float* block) {
-	updateAngleDelta(frequency);
-	for (unsigned i = 0; i < blockSize; i++) {
-		float angleMod = std::fmod(currentAngle, 2.0f) - 1.0f;
-		block[i] = (angleMod < 0) ? -1.0f : 1.0f;
-		currentAngle += angleDelta;
-	}
+void Oscillators::Square::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	phase.fill(frequencies, sampleRate, blockSize, block);
+	shape(frequencies, blockSize, block);
 }
 
-float* Oscillators::Square::writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) {
-	updateAngleDelta(frequency);
-	for (unsigned i = 0; i < blockSize; i++) {
-		float angleMod = std::fmod(currentAngle, 2.0f) - 1.0f;
-		block[i] = (angleMod < 0) ? -1.0f : 1.0f;
-		block[i] *= amplitude;
-		currentAngle += angleDelta;
+void Oscillators::Square::renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points) {
+	// Each point moves the phase on by stride samples at its pitch
+	phase.fill(frequencies, (double)sampleRate / stride, numPoints, points);
+	shape(frequencies, numPoints, points);
+}
+
+void Oscillators::Square::shape(const float* frequencies, const unsigned& blockSize, float* block) {
+	if (antialiasing == Oscillators::Antialiasing::POLYBLEP) {
+		const Simd::Float inverseSampleRate = Simd::set(1.0f / sampleRate);
+		Simd::transform(blockSize, block, frequencies, [&](const Simd::Float& phases, const Simd::Float& frequency) {
+			// A zero increment makes inverseDt infinite, but then neither polynomial branch is selected
+			Simd::Float dt = Simd::mul(Simd::abs(frequency), inverseSampleRate);
+			return antialiased(phases, dt, Simd::div(Simd::set(1.0f), dt));
+		});
+	}
+	else {
+		Simd::transform(blockSize, block, [](const Simd::Float& phases) { return Simd::square(phases); });
 	}
 }
\ No newline at end of file
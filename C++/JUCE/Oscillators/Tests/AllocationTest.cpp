@@ -0,0 +1,253 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+#include "../Oscillators.h"
+
+// Every allocation in the process goes through these, so a render that allocates shows up in the count
+namespace {
+	std::atomic<unsigned long long> allocations{ 0 };
+
+	void* allocate(std::size_t size, std::size_t alignment) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		size = (size == 0) ? 1 : size;
+		void* memory = nullptr;
+		if (alignment <= alignof(std::max_align_t)) {
+			memory = std::malloc(size);
+		}
+		else {
+			// aligned_alloc wants a multiple of the alignment
+			memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+		}
+		if (!memory) {
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+};
+
+void* operator new(std::size_t size) { return allocate(size, 0); }
+void* operator new[](std::size_t size) { return allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, (std::size_t)alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+namespace {
+	const float SAMPLE_RATE = 48000.0f;
+	const float FREQUENCY = 440.0f;
+	const unsigned MAX_BLOCK_SIZE = 512;
+	// Odd sizes too, so tails and partial chunks are rendered
+	const unsigned BLOCK_SIZES[] = { 1, 37, 64, 256, MAX_BLOCK_SIZE };
+
+	unsigned failures = 0;
+
+	/// <summary>
+	/// Run a render path for every block size and report whether anything was allocated
+	/// </summary>
+	template <typename Render>
+	void check(const char* name, const char* path, const Render& render) {
+		const unsigned long long before = allocations.load();
+		for (unsigned blockSize : BLOCK_SIZES) {
+			for (unsigned repeat = 0; repeat < 3; repeat++) {
+				render(blockSize);
+			}
+		}
+		const unsigned long long count = allocations.load() - before;
+		if (count != 0) {
+			failures++;
+			std::printf("FAIL %s %s: %llu allocations\n", name, path, count);
+		}
+		else {
+			std::printf("ok   %s %s\n", name, path);
+		}
+	}
+
+	/// <summary>
+	/// Every public render path of an Oscillator, at audio and at control rate
+	/// </summary>
+	void checkPaths(const char* name, Oscillators::Oscillator& oscillator) {
+		std::vector<float> block(MAX_BLOCK_SIZE);
+		std::vector<float> frequencies(MAX_BLOCK_SIZE);
+		std::vector<float> amplitudes(MAX_BLOCK_SIZE, 0.5f);
+		for (unsigned i = 0; i < MAX_BLOCK_SIZE; i++) {
+			frequencies[i] = FREQUENCY * (1.0f + 0.01f * (float)(i % 7));
+		}
+		const Oscillators::Oscillator::Event events[] = {
+			{ 0, Oscillators::Oscillator::Event::Kind::AMPLITUDE, 0.5f },
+			{ 0, Oscillators::Oscillator::Event::Kind::FREQUENCY, FREQUENCY },
+			{ 10, Oscillators::Oscillator::Event::Kind::PHASE_RESET, 0.25f },
+			{ 20, Oscillators::Oscillator::Event::Kind::TABLE, 0.0f, nullptr },
+			{ 30, Oscillators::Oscillator::Event::Kind::FREQUENCY, 2.0f * FREQUENCY }
+		};
+		const unsigned numEvents = sizeof(events) / sizeof(events[0]);
+		juce::AudioBuffer<float> buffer(2, (int)MAX_BLOCK_SIZE);
+		oscillator.prepare(MAX_BLOCK_SIZE);
+
+		for (unsigned decimation : { 1u, 32u }) {
+			oscillator.setControlRate(decimation);
+			const bool control = decimation > 1;
+			check(name, control ? "getBlock (control rate)" : "getBlock", [&](const unsigned& blockSize) {
+				oscillator.getBlock(FREQUENCY, blockSize);
+				oscillator.getBlock(FREQUENCY, blockSize, 0.5f);
+			});
+			check(name, control ? "writeBlock (control rate)" : "writeBlock", [&](const unsigned& blockSize) {
+				oscillator.writeBlock(FREQUENCY, blockSize, block.data());
+				oscillator.writeBlock(FREQUENCY, blockSize, 0.5f, block.data());
+				// A literal 0 amplitude must pick the scalar overload
+				oscillator.writeBlock(FREQUENCY, blockSize, 0, block.data());
+				oscillator.writeBlockAmplitudes(FREQUENCY, blockSize, amplitudes.data(), block.data());
+				oscillator.writeBlock(frequencies.data(), blockSize, block.data());
+				oscillator.writeBlockAmplitudes(frequencies.data(), blockSize, amplitudes.data(), block.data());
+				oscillator.writeBlock(FREQUENCY, 2.0f * FREQUENCY, blockSize, 0.0f, 1.0f, block.data());
+				oscillator.writeBlock(events, numEvents, blockSize, block.data());
+			});
+			check(name, control ? "addBlock (control rate)" : "addBlock", [&](const unsigned& blockSize) {
+				oscillator.addBlock(FREQUENCY, blockSize, 1e-3f, block.data());
+				oscillator.addBlock(frequencies.data(), blockSize, 1e-3f, block.data());
+				oscillator.addBlock(events, numEvents, blockSize, 1e-3f, block.data());
+			});
+			check(name, control ? "AudioBuffer (control rate)" : "AudioBuffer", [&](const unsigned&) {
+				oscillator.writeBlock(FREQUENCY, buffer);
+				oscillator.writeBlock(FREQUENCY, 0.5f, buffer);
+				oscillator.addBlock(FREQUENCY, 1e-3f, buffer);
+			});
+		}
+		oscillator.setControlRate(1);
+		check(name, "getControlValue", [&](const unsigned& blockSize) {
+			block[0] = oscillator.getControlValue(5.0f, blockSize);
+		});
+	}
+};
+
+int main() {
+	{
+		Oscillators::Saw naive(SAMPLE_RATE);
+		Oscillators::Saw polyBlep(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+		Oscillators::Square square(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+		Oscillators::Triangle triangle(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+		checkPaths("Saw", naive);
+		checkPaths("Saw polyblep", polyBlep);
+		checkPaths("Square polyblep", square);
+		checkPaths("Triangle polyblep", triangle);
+	}
+	{
+		Oscillators::Sine exact(SAMPLE_RATE, Oscillators::Accuracy::BIT_ACCURATE);
+		Oscillators::Sine polynomial(SAMPLE_RATE, Oscillators::Accuracy::MINUS_120_DB);
+		Oscillators::Sine phasor(SAMPLE_RATE, Oscillators::Accuracy::MINUS_90_DB);
+		checkPaths("Sine bit-accurate", exact);
+		checkPaths("Sine -120dB", polynomial);
+		checkPaths("Sine -90dB", phasor);
+	}
+	{
+		Oscillators::Theremin theremin(SAMPLE_RATE);
+		Oscillators::Noise white(Oscillators::NoiseColour::WHITE, SAMPLE_RATE);
+		Oscillators::Noise pink(Oscillators::NoiseColour::PINK, SAMPLE_RATE);
+		Oscillators::Noise brown(Oscillators::NoiseColour::BROWN, SAMPLE_RATE);
+		checkPaths("Theremin", theremin);
+		checkPaths("Noise white", white);
+		checkPaths("Noise pink", pink);
+		checkPaths("Noise brown", brown);
+	}
+	{
+		Oscillators::Wavetable saw(Oscillators::Type::SAW);
+		Oscillators::Wavetable hermite(Oscillators::Type::SQUARE);
+		saw.setSampleRate(SAMPLE_RATE);
+		saw.setCrossfade(true);
+		hermite.setSampleRate(SAMPLE_RATE);
+		hermite.setInterpolation(Oscillators::InterpolationMode::HERMITE);
+		checkPaths("Wavetable<Saw> crossfade", saw);
+		checkPaths("Wavetable<Square> hermite", hermite);
+		Oscillators::FixedWavetable<2048, Oscillators::Type::SAW, 32> fixed(SAMPLE_RATE);
+		checkPaths("FixedWavetable<2048, Saw, 32>", fixed);
+		Oscillators::OscillatorAdapter<Oscillators::Shapes::Sine, Oscillators::Interpolation::None> adapter(SAMPLE_RATE);
+		checkPaths("OscillatorAdapter<Sine>", adapter);
+	}
+	{
+		Oscillators::Unison unison(Oscillators::Type::SAW, SAMPLE_RATE, 7);
+		checkPaths("Unison<Saw>", unison);
+		std::vector<float> left(MAX_BLOCK_SIZE), right(MAX_BLOCK_SIZE), frames(2 * MAX_BLOCK_SIZE), frequencies(MAX_BLOCK_SIZE, FREQUENCY);
+		juce::AudioBuffer<float> buffer(2, (int)MAX_BLOCK_SIZE);
+		check("Unison<Saw>", "stereo", [&](const unsigned& blockSize) {
+			unison.writeStereo(FREQUENCY, blockSize, left.data(), right.data());
+			unison.writeStereo(frequencies.data(), blockSize, left.data(), right.data());
+			unison.writeStereo(FREQUENCY, buffer);
+			unison.writeInterleaved(FREQUENCY, blockSize, frames.data());
+		});
+	}
+	{
+		Oscillators::Saw saw(SAMPLE_RATE);
+		Oscillators::Oversampler oversampler(saw, 4, SAMPLE_RATE);
+		checkPaths("Oversampler<Saw> 4x", oversampler);
+	}
+	{
+		Oscillators::OperatorGraph graph(4, SAMPLE_RATE);
+		graph.setRatio(1, 14.0f);
+		graph.setModulation(1, 0, 2.0f);
+		graph.setModulation(3, 2, 1.0f);
+		graph.setFeedback(3, 0.5f);
+		checkPaths("OperatorGraph", graph);
+	}
+	{
+		Oscillators::SineBank bank(SAMPLE_RATE);
+		bank.setHarmonics(std::vector<float>(64, 0.01f), {});
+		checkPaths("SineBank", bank);
+	}
+	{
+		Oscillators::BasicOscillator<Oscillators::Shapes::Saw, Oscillators::Interpolation::None> basic(SAMPLE_RATE);
+		std::vector<float> block(MAX_BLOCK_SIZE), frequencies(MAX_BLOCK_SIZE, FREQUENCY);
+		check("BasicOscillator<Saw>", "writeBlock/addBlock", [&](const unsigned& blockSize) {
+			basic.writeBlock(FREQUENCY, blockSize, block.data());
+			basic.writeBlock(frequencies.data(), blockSize, block.data());
+			basic.writeBlock(FREQUENCY, blockSize, 0.5f, block.data());
+			basic.addBlock(FREQUENCY, blockSize, 1e-3f, block.data());
+			basic.addBlock(frequencies.data(), blockSize, 1e-3f, block.data());
+		});
+
+		Oscillators::OscillatorBank bank(Oscillators::Type::SAW, SAMPLE_RATE, 16);
+		for (unsigned voice = 0; voice < 16; voice++) {
+			bank.setVoice(voice, FREQUENCY * (1.0f + 0.01f * voice), 1.0f / 16);
+		}
+		check("OscillatorBank<Saw>", "writeBlock/addBlock", [&](const unsigned& blockSize) {
+			bank.writeBlock(blockSize, block.data());
+			bank.addBlock(blockSize, 1e-3f, block.data());
+		});
+	}
+	{
+		Oscillators::VoicePool pool(4, SAMPLE_RATE);
+		std::vector<float> block(MAX_BLOCK_SIZE);
+		const Oscillators::Type types[] = { Oscillators::Type::SAW, Oscillators::Type::SQUARE, Oscillators::Type::SINE, Oscillators::Type::TRIANGLE, Oscillators::Type::THEREMIN };
+		int note = 0;
+		check("VoicePool", "noteOn/process/noteOff", [&](const unsigned& blockSize) {
+			// More notes than voices, so stealing runs too
+			for (const Oscillators::Type& type : types) {
+				pool.noteOn(type, note++ % 12, FREQUENCY, 0.1f);
+			}
+			pool.process(blockSize, block.data());
+			pool.noteOff((note + 6) % 12);
+		});
+	}
+	{
+		std::vector<std::unique_ptr<Oscillators::Sine>> sines;
+		Oscillators::RenderEngine engine(2, MAX_BLOCK_SIZE);
+		for (unsigned voice = 0; voice < 16; voice++) {
+			sines.push_back(std::make_unique<Oscillators::Sine>(SAMPLE_RATE));
+			engine.setVoice(engine.addVoice(*sines.back()), FREQUENCY * (1.0f + 0.01f * voice), 1.0f / 16);
+		}
+		std::vector<float> block(MAX_BLOCK_SIZE);
+		check("RenderEngine", "process", [&](const unsigned& blockSize) {
+			engine.process(blockSize, block.data());
+		});
+	}
+
+	std::printf("%s\n", (failures == 0) ? "no allocations while rendering" : "allocations while rendering");
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../Oscillators.h"
+
+namespace {
+	const float SAMPLE_RATE = 48000.0f;
+	const unsigned BLOCK_SIZE = 1000;
+
+	unsigned failures = 0;
+
+	/// <summary>
+	/// Render a PolyBLEP oscillator forwards and backwards from phase 0 and compare the two.
+	/// Running a shape backwards reads it at 1 - phase, which negates the saw and the square
+	/// and leaves the triangle unchanged, corrections included.
+	/// </summary>
+	template <class Shape>
+	void checkMirror(const char* name, const float& sign, const float& frequency, const bool& perSample) {
+		Shape forwards(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+		Shape backwards(SAMPLE_RATE, Oscillators::Antialiasing::POLYBLEP);
+		std::vector<float> block(BLOCK_SIZE);
+		std::vector<float> reversed(BLOCK_SIZE);
+		if (perSample) {
+			const std::vector<float> up(BLOCK_SIZE, frequency);
+			const std::vector<float> down(BLOCK_SIZE, -frequency);
+			forwards.writeBlock(up.data(), BLOCK_SIZE, block.data());
+			backwards.writeBlock(down.data(), BLOCK_SIZE, reversed.data());
+		}
+		else {
+			forwards.writeBlock(frequency, BLOCK_SIZE, block.data());
+			backwards.writeBlock(-frequency, BLOCK_SIZE, reversed.data());
+		}
+
+		float error = 0.0f;
+		for (unsigned i = 0; i < BLOCK_SIZE; i++) {
+			error = std::fmax(error, std::fabs(block[i] - sign * reversed[i]));
+		}
+		const bool passed = error < 1e-3f;
+		failures += passed ? 0 : 1;
+		std::printf("%s %s at -%g Hz (%s): error %.3g\n", passed ? "ok  " : "FAIL", name, frequency,
+			perSample ? "per sample" : "constant", error);
+	}
+};
+
+int main() {
+	// The constant pitch path used to take the correction width from the unsigned increment,
+	// nearly a whole cycle at a negative pitch
+	for (float frequency : { 440.0f, 5000.0f }) {
+		for (bool perSample : { false, true }) {
+			checkMirror<Oscillators::Saw>("Saw", -1.0f, frequency, perSample);
+			checkMirror<Oscillators::Square>("Square", -1.0f, frequency, perSample);
+			checkMirror<Oscillators::Triangle>("Triangle", 1.0f, frequency, perSample);
+		}
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
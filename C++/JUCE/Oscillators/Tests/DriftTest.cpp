@@ -0,0 +1,91 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "../Oscillators.h"
+
+namespace {
+	const uint64_t SAMPLE_RATE = 48000;
+	const uint64_t SAMPLES = 24ull * 60 * 60 * SAMPLE_RATE;
+	const unsigned BLOCK_SIZE = 512;
+
+	/// <summary>
+	/// Pitch as an exact fraction of Hz, with a power of two denominator so the double is exact too
+	/// </summary>
+	struct Pitch {
+		uint64_t numerator;
+		uint64_t denominator;
+	};
+
+	/// <summary>
+	/// Distance between two phases in cycles, across the wrap
+	/// </summary>
+	double distance(const double& a, const double& b) {
+		double difference = a - b;
+		difference -= std::floor(difference + 0.5);
+		return std::fabs(difference);
+	}
+};
+
+int main() {
+	// A very low, an ordinary, a non-integer and a high pitch
+	const Pitch pitches[] = { { 1, 1 }, { 440, 1 }, { 55, 2 }, { 53159, 4 } };
+	std::vector<float> phases(BLOCK_SIZE);
+	unsigned failures = 0;
+
+	for (const Pitch& pitch : pitches) {
+		const double frequency = (double)pitch.numerator / (double)pitch.denominator;
+		const double cycles = frequency / (double)SAMPLE_RATE;
+		// Bounds documented in PhaseAccumulator.h: the carried phase only drifts by the rounding
+		// of the increment, the phases of a block stay within blockSize / 2^32 of it plus float resolution
+		const double carriedBound = (double)SAMPLES * (cycles * std::ldexp(1.0, -53) + std::ldexp(1.0, -64)) + std::ldexp(1.0, -64);
+		const double blockBound = carriedBound + BLOCK_SIZE * std::ldexp(1.0, -32) + std::ldexp(1.0, -24);
+
+		Oscillators::PhaseAccumulator accumulator;
+		accumulator.setFrequency(frequency, (double)SAMPLE_RATE);
+		// Phase after n samples is frac(n * numerator / (denominator * sampleRate)), kept exact in integers
+		const uint64_t period = pitch.denominator * SAMPLE_RATE;
+		double carriedError = 0.0;
+		double blockError = 0.0;
+
+		for (uint64_t start = 0; start < SAMPLES; start += BLOCK_SIZE) {
+			const unsigned blockSize = (SAMPLES - start < BLOCK_SIZE) ? (unsigned)(SAMPLES - start) : BLOCK_SIZE;
+			accumulator.fill(blockSize, phases.data());
+			const double first = (double)(start * pitch.numerator % period) / (double)period;
+			const double last = (double)((start + blockSize - 1) * pitch.numerator % period) / (double)period;
+			const double next = (double)((start + blockSize) * pitch.numerator % period) / (double)period;
+			blockError = std::fmax(blockError, std::fmax(distance(phases[0], first), distance(phases[blockSize - 1], last)));
+			carriedError = std::fmax(carriedError, distance(accumulator.getPhase(), next));
+		}
+
+		const bool passed = carriedError <= carriedBound && blockError <= blockBound;
+		failures += passed ? 0 : 1;
+		std::printf("%s %g Hz over 24 h: carried phase error %.3g (bound %.3g), block phase error %.3g (bound %.3g) cycles\n",
+			passed ? "ok  " : "FAIL", frequency, carriedError, carriedBound, blockError, blockBound);
+	}
+
+	// Per-sample pitches at or past Nyquist, e.g. an FM operator at ratio 14 on a 2 kHz carrier,
+	// must wrap like setFrequency's instead of overflowing the 32-bit increment
+	for (float frequency : { 28000.0f, -30000.0f, 60000.0f, 123456.0f }) {
+		Oscillators::PhaseAccumulator fixed;
+		Oscillators::PhaseAccumulator perSample;
+		fixed.setFrequency(frequency, (double)SAMPLE_RATE);
+		const std::vector<float> frequencies(BLOCK_SIZE, frequency);
+		std::vector<float> expected(BLOCK_SIZE);
+		double error = 0.0;
+		for (unsigned block = 0; block < 16; block++) {
+			fixed.fill(BLOCK_SIZE, expected.data());
+			perSample.fill(frequencies.data(), (double)SAMPLE_RATE, BLOCK_SIZE, phases.data());
+			for (unsigned i = 0; i < BLOCK_SIZE; i++) {
+				error = std::fmax(error, distance(phases[i], expected[i]));
+			}
+		}
+		// The per-sample increment is rounded to 2^-32 every sample, the fixed one is not
+		const double bound = 16.0 * BLOCK_SIZE * std::ldexp(1.0, -32) + std::ldexp(1.0, -23);
+		const bool passed = error <= bound;
+		failures += passed ? 0 : 1;
+		std::printf("%s %g Hz per sample: phase error %.3g (bound %.3g) cycles\n", passed ? "ok  " : "FAIL", frequency, error, bound);
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Oscillators.h"
+
+#if !defined(LOTKEY_OSCILLATORS_INSTRUMENTATION)
+#error "Build with -DLOTKEY_OSCILLATORS_INSTRUMENTATION"
+#endif
+
+namespace {
+	const float SAMPLE_RATE = 48000.0f;
+	// Three times the threads Instrumentation.cpp has counters for
+	const unsigned SHORT_LIVED_THREADS = 192;
+
+	unsigned failures = 0;
+
+	void report(const bool& passed, const char* name, const unsigned long long& value, const unsigned long long& expected) {
+		failures += passed ? 0 : 1;
+		std::printf("%s %s: %llu (expected %llu)\n", passed ? "ok  " : "FAIL", name, value, expected);
+	}
+
+	/// <summary>
+	/// Totals of one class, zero if it never rendered
+	/// </summary>
+	Oscillators::Instrumentation::TypeStats find(const Oscillators::Instrumentation::Snapshot& snapshot, const std::string& name) {
+		for (const Oscillators::Instrumentation::TypeStats& stats : snapshot.types) {
+			if (stats.name == name) {
+				return stats;
+			}
+		}
+		return Oscillators::Instrumentation::TypeStats();
+	}
+};
+
+int main() {
+	// The main thread renders Saw in timed callbacks while a short-lived worker renders Square,
+	// with one callback given a deadline it cannot meet
+	{
+		std::thread worker([]() {
+			Oscillators::Square square(SAMPLE_RATE);
+			std::vector<float> block(128);
+			for (unsigned i = 0; i < 50; i++) {
+				square.writeBlock(440.0f, 128, block.data());
+			}
+			const Oscillators::Instrumentation::CallbackScope callback(1, 1e12);
+			square.writeBlock(440.0f, 128, block.data());
+		});
+
+		Oscillators::Saw saw(SAMPLE_RATE);
+		std::vector<float> block(256);
+		for (unsigned i = 0; i < 100; i++) {
+			const Oscillators::Instrumentation::CallbackScope callback(256, SAMPLE_RATE);
+			saw.writeBlock(440.0f, 256, block.data());
+		}
+		worker.join();
+	}
+
+	Oscillators::Instrumentation::Snapshot snapshot = Oscillators::Instrumentation::snapshot();
+	const Oscillators::Instrumentation::TypeStats saw = find(snapshot, "Oscillators::Saw");
+	const Oscillators::Instrumentation::TypeStats square = find(snapshot, "Oscillators::Square");
+	report(saw.blocks == 100, "Saw blocks", saw.blocks, 100);
+	report(saw.samples == 100 * 256, "Saw samples", saw.samples, 100 * 256);
+	report(square.blocks == 51, "Square blocks from the exited thread", square.blocks, 51);
+	report(square.samples == 51 * 128, "Square samples from the exited thread", square.samples, 51 * 128);
+	report(snapshot.callbacks == 101, "callbacks", snapshot.callbacks, 101);
+	report(snapshot.deadlineMisses >= 1 && snapshot.deadlineMisses <= snapshot.callbacks, "deadline misses, at least", snapshot.deadlineMisses, 1);
+
+	// Each thread hands its counters back when it exits; without that, threads past the
+	// number of counters would not be recorded at all
+	for (unsigned i = 0; i < SHORT_LIVED_THREADS; i++) {
+		std::thread([]() {
+			Oscillators::Triangle triangle(SAMPLE_RATE);
+			std::vector<float> block(64);
+			triangle.writeBlock(440.0f, 64, block.data());
+		}).join();
+	}
+
+	snapshot = Oscillators::Instrumentation::snapshot();
+	const Oscillators::Instrumentation::TypeStats triangle = find(snapshot, "Oscillators::Triangle");
+	report(triangle.blocks == SHORT_LIVED_THREADS, "Triangle blocks from reused counters", triangle.blocks, SHORT_LIVED_THREADS);
+	// Released counters keep their totals
+	report(find(snapshot, "Oscillators::Square").blocks == 51, "Square blocks after reuse", find(snapshot, "Oscillators::Square").blocks, 51);
+
+	return (failures == 0) ? 0 : 1;
+}
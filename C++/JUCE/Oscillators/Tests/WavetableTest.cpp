@@ -0,0 +1,78 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../Oscillators.h"
+
+namespace {
+	const float SAMPLE_RATE = 48000.0f;
+	const unsigned BLOCK_SIZE = 512;
+
+	unsigned failures = 0;
+
+	void report(const bool& passed, const char* name) {
+		failures += passed ? 0 : 1;
+		std::printf("%s %s\n", passed ? "ok  " : "FAIL", name);
+	}
+
+	/// <summary>
+	/// Whether every sample is finite and within the overshoot of a band-limited shape
+	/// </summary>
+	bool bounded(const std::vector<float>& block) {
+		for (float sample : block) {
+			if (!std::isfinite(sample) || std::fabs(sample) > 1.5f) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+int main() {
+	std::vector<float> block(BLOCK_SIZE);
+	std::vector<float> reversed(BLOCK_SIZE);
+
+	// Positions used to wrap only once and, for a constant pitch, only upwards; the gather then read outside the table
+	{
+		Oscillators::Wavetable saw(Oscillators::Type::SAW);
+		saw.setSampleRate(SAMPLE_RATE);
+		saw.writeBlock(-440.0f, BLOCK_SIZE, block.data());
+		report(bounded(block), "negative pitch");
+	}
+	for (float frequency : { 60000.0f, -60000.0f, 1e7f }) {
+		Oscillators::Wavetable saw(Oscillators::Type::SAW);
+		saw.setSampleRate(SAMPLE_RATE);
+		bool passed = true;
+		for (unsigned repeat = 0; repeat < 4; repeat++) {
+			saw.writeBlock(frequency, BLOCK_SIZE, block.data());
+			passed = passed && bounded(block);
+		}
+		report(passed, (frequency > 0.0f) ? "pitch above the sample rate" : "negative pitch above the sample rate");
+	}
+	{
+		Oscillators::Wavetable saw(Oscillators::Type::SAW);
+		saw.setSampleRate(SAMPLE_RATE);
+		std::vector<float> frequencies(BLOCK_SIZE);
+		for (unsigned i = 0; i < BLOCK_SIZE; i++) {
+			frequencies[i] = (i % 2 == 0) ? 250000.0f : -180000.0f;
+		}
+		saw.writeBlock(frequencies.data(), BLOCK_SIZE, block.data());
+		report(bounded(block), "per-sample pitches of several tables per sample");
+	}
+
+	// The saw is odd, so running it backwards from phase 0 mirrors it
+	{
+		Oscillators::Wavetable forwards(Oscillators::Type::SAW);
+		Oscillators::Wavetable backwards(Oscillators::Type::SAW);
+		forwards.setSampleRate(SAMPLE_RATE);
+		backwards.setSampleRate(SAMPLE_RATE);
+		forwards.writeBlock(440.0f, BLOCK_SIZE, block.data());
+		backwards.writeBlock(-440.0f, BLOCK_SIZE, reversed.data());
+		float error = 0.0f;
+		for (unsigned i = 0; i < BLOCK_SIZE; i++) {
+			error = std::fmax(error, std::fabs(block[i] + reversed[i]));
+		}
+		report(error < 1e-3f, "negative pitch mirrors positive pitch");
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#include <cmath>
+#include "Theremin.h"
+#include "Simd.h"
+
+namespace {
+	// Relative distance below which the glide snaps onto its target
+	constexpr double SETTLED = 1e-6;
+};
+
+Oscillators::Theremin::Theremin(const float& sampleRate) {
+	this->sampleRate = sampleRate;
+	updateGlide();
+}
+
+void Oscillators::Theremin::setSampleRate(const float& sampleRate) {
+	this->sampleRate = sampleRate;
+	updateGlide();
+}
+
+void Oscillators::Theremin::setGlide(const float& seconds) {
+	glideTime = (seconds > 0.0f) ? seconds : 0.0f;
+	updateGlide();
+}
+
+void Oscillators::Theremin::updateGlide() {
+	const double coefficient = (glideTime > 0.0f) ? std::exp(-1.0 / ((double)glideTime * sampleRate)) : 0.0;
+	double power = 1.0;
+	for (unsigned i = 0; i < CHUNK_SIZE; i++) {
+		power *= coefficient;
+		glidePowers[i] = (float)power;
+	}
+}
+
+void Oscillators::Theremin::setVibrato(const float& rate, const float& depth) {
+	vibratoRate = rate;
+	vibratoDepth = depth;
+}
+
+void Oscillators::Theremin::resetPhase(const double& cycles) {
+	phase.reset(cycles);
+	vibratoPhase = 0.0;
+}
+
+template <bool PerSample>
+void Oscillators::Theremin::renderGlide(const float* frequencies, const unsigned& blockSize, float* block) {
+	if (blockSize == 0) {
+		return;
+	}
+	const double coefficient = (glideTime > 0.0f) ? std::exp(-1.0 / ((double)glideTime * sampleRate)) : 0.0;
+	const double vibratoDelta = (double)vibratoRate / sampleRate;
+	const double depth = vibratoDepth / 1200.0;
+	if (currentFrequency < 0.0) {
+		currentFrequency = frequencies[0];
+	}
+
+	float pitches[CHUNK_SIZE];
+	for (unsigned start = 0; start < blockSize; start += CHUNK_SIZE) {
+		const unsigned count = (blockSize - start < CHUNK_SIZE) ? blockSize - start : CHUNK_SIZE;
+
+		if (PerSample) {
+			double current = currentFrequency;
+			for (unsigned i = 0; i < count; i++) {
+				current = frequencies[start + i] + coefficient * (current - frequencies[start + i]);
+				pitches[i] = (float)current;
+			}
+			currentFrequency = current;
+		}
+		else {
+			// A fixed target glides in closed form: target + distance * coefficient^(i + 1)
+			const double target = frequencies[0];
+			const double distance = currentFrequency - target;
+			if (std::fabs(distance) <= SETTLED * std::fabs(target)) {
+				currentFrequency = target;
+				if (vibratoDepth == 0.0f) {
+					phase.setFrequency(target, sampleRate);
+					phase.fill(count, block + start);
+					Simd::transform(count, block + start, [](const Simd::Float& phases) { return Simd::sine(phases); });
+					continue;
+				}
+			}
+			for (unsigned i = 0; i < count; i++) {
+				pitches[i] = (float)target + (float)distance * glidePowers[i];
+			}
+			currentFrequency = target + distance * glidePowers[count - 1];
+		}
+
+		if (vibratoDepth != 0.0f) {
+			// Exact at the chunk edges, linear in between
+			const double startRatio = std::exp2(depth * std::sin(2.0 * PI * vibratoPhase));
+			vibratoPhase += count * vibratoDelta;
+			vibratoPhase -= std::floor(vibratoPhase);
+			const double endRatio = std::exp2(depth * std::sin(2.0 * PI * vibratoPhase));
+			const float ratioStep = (float)((endRatio - startRatio) / count);
+			for (unsigned i = 0; i < count; i++) {
+				pitches[i] *= (float)startRatio + ratioStep * (float)i;
+			}
+		}
+		phase.fill(pitches, sampleRate, count, block + start);
+		Simd::transform(count, block + start, [](const Simd::Float& phases) { return Simd::sine(phases); });
+	}
+}
+
+void Oscillators::Theremin::render(const float& frequency, const unsigned& blockSize, float* block) {
+	renderGlide<false>(&frequency, blockSize, block);
+}
+
+void Oscillators::Theremin::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	renderGlide<true>(frequencies, blockSize, block);
+}
@@ -0,0 +1,85 @@
+#ifndef LOTKEY_CPP_JUCE_THEREMIN_H
+#define LOTKEY_CPP_JUCE_THEREMIN_H
+
+#include "Oscillators.h"
+
+/// <summary>
+/// Type::THEREMIN: a sine whose pitch glides continuously towards the requested one and
+/// carries its own vibrato. Both run per sample inside the block, so a pitch that only
+/// changes once per block still slides smoothly. The glide is a one-pole lag on the
+/// frequency; the vibrato is a sine LFO in cents, evaluated exactly every 64 samples and
+/// interpolated linearly in between (off by under 0.03 cent at 6 Hz and a semitone of depth).
+/// Phases come from a PhaseAccumulator and the sine is the MINUS_120_DB polynomial,
+/// vectorised over 64-sample chunks. Once the glide has settled and without vibrato it
+/// renders like Sine, at a fixed increment.
+/// </summary>
+class Oscillators::Theremin : public Oscillators::Oscillator {
+private:
+	static constexpr unsigned CHUNK_SIZE = 64;
+
+	float sampleRate = 48000;
+	float glideTime = 0.08f;
+	float vibratoRate = 5.5f;
+	float vibratoDepth = 20.0f;
+
+	Oscillators::PhaseAccumulator phase;
+	// Glided pitch (Hz), negative until the first block sets it
+	double currentFrequency = -1.0;
+	// Vibrato LFO phase (cycles)
+	double vibratoPhase = 0.0;
+	// Share of the distance to the pitch left after 1, 2, ... samples of glide
+	float glidePowers[CHUNK_SIZE] = {};
+
+	void updateGlide();
+	template <bool PerSample>
+	void renderGlide(const float* frequencies, const unsigned& blockSize, float* block);
+protected:
+	/// <summary>
+	/// Render the next block, gliding towards a pitch
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) to glide to </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Render the next block, gliding towards a pitch that changes every sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) to glide to at each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
+public:
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	Theremin(const float& sampleRate);
+	/// <summary>
+	/// Set the sample rate of the oscillator
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) override;
+	/// <summary>
+	/// Set how quickly the pitch follows. The first block after construction or
+	/// snapTo starts at its pitch.
+	/// </summary>
+	/// <param name="seconds"> - time constant of the glide, 0 to jump </param>
+	void setGlide(const float& seconds);
+	/// <summary>
+	/// Set the vibrato
+	/// </summary>
+	/// <param name="rate"> - LFO rate (Hz) </param>
+	/// <param name="depth"> - pitch swing (cents) either side of the pitch, 0 for none </param>
+	void setVibrato(const float& rate, const float& depth);
+	/// <summary>
+	/// Start the next block at its pitch instead of gliding to it
+	/// </summary>
+	void snapTo() { currentFrequency = -1.0; }
+	/// <summary>
+	/// Restart the phase; the vibrato restarts at its centre
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override;
+};
+
+#endif
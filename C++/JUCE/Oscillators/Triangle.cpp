@@ -1,59 +1,80 @@
 #include <cmath>
-#include "TriangleOscillator.h"
+#include "Triangle.h"
+#include "Simd.h"
+
+namespace {
+	using namespace Oscillators;
+
+	Simd::Float antialiased(const Simd::Float& phases, const Simd::Float& dt, const Simd::Float& inverseDt) {
+		Simd::Float opposite = Simd::wrap(Simd::add(phases, Simd::set(0.5f)));
+		Simd::Float rounding = Simd::sub(Simd::polyBlamp(phases, dt, inverseDt), Simd::polyBlamp(opposite, dt, inverseDt));
+		return Simd::mulAdd(Simd::mul(Simd::set(4.0f), dt), rounding, Simd::triangle(phases));
+	}
+};
 
 void Oscillators::Triangle::updateAngleDelta(const double& frequency) {
-	double cyclesPerSample = frequency / sampleRate;
-	angleDelta = cyclesPerSample * 2.0;
+	phase.setFrequency(frequency, sampleRate);
 }
 
 Oscillators::Triangle::Triangle(const float& sampleRate) {
 	this->sampleRate = sampleRate;
 }
 
+Oscillators::Triangle::Triangle(const float& sampleRate, const Oscillators::Antialiasing& antialiasing) {
+	this->sampleRate = sampleRate;
+	this->antialiasing = antialiasing;
+}
+
+void Oscillators::Triangle::setAntialiasing(const Oscillators::Antialiasing& antialiasing) {
+	this->antialiasing = antialiasing;
+}
+
 void Oscillators::Triangle::setSampleRate(const float& sampleRate) {
 	this->sampleRate = sampleRate;
 }
 
-float* Oscillators::Triangle::getBlock(const float& frequency, const unsigned& blockSize) {
-	updateAngleDelta(frequency);
-	float* block = new float[blockSize];
-	for (unsigned i = 0; i < blockSize; i++) {
-		float mod = std::fmod(currentAngle, 2.0f) - 1.0f;
-		float sample = (mod < 0.0f) ? mod + 0.5f : (1.0f - mod) - 0.5f;
-		block[i] = sample * 2;
-		currentAngle += angleDelta;
-	}
-	return block;
+void Oscillators::Triangle::resetPhase(const double& cycles) {
+	phase.reset(cycles);
 }
 
-float* Oscillators::Triangle::getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude) {
+void Oscillators::Triangle::render(const float& frequency, const unsigned& blockSize, float* block) {
 	updateAngleDelta(frequency);
-	float* block = new float[blockSize];
-	for (unsigned i = 0; i < blockSize; i++) {
-		float mod = std::fmod(currentAngle, 2.0f) - 1.0f;
-		float sample = (mod < 0.0f) ? mod + 0.5f : (1.0f - mod) - 0.5f;
-		block[i] = sample * 2 * amplitude;
-		currentAngle += angleDelta;
+	phase.fill(blockSize, block);
+
+	if (antialiasing == Oscillators::Antialiasing::POLYBLEP) {
+		// The width of the correction is the distance moved per sample, whichever way the phase runs.
+		// A zero increment makes inverseDt infinite, but then neither polynomial branch is selected
+		const float increment = std::fabs(frequency) / sampleRate;
+		const Simd::Float dt = Simd::set(increment);
+		const Simd::Float inverseDt = Simd::set(1.0f / increment);
+		Simd::transform(blockSize, block, [&](const Simd::Float& phases) { return antialiased(phases, dt, inverseDt); });
+	}
+	else {
+		Simd::transform(blockSize, block, [](const Simd::Float& phases) { return Simd::triangle(phases); });
 	}
-	return block;
 }
 
-void Oscillators::Triangle::writeBlock(const float& frequency, const unsigned& blockSize, const float* block) {
-	updateAngleDelta(frequency);
-	for (unsigned i = 0; i < blockSize; i++) {
-		float mod = std::fmod(currentAngle, 2.0f) - 1.0f;
-		float sample = (mod < 0.0f) ? mod + 0.5f : (1.0f - mod) - 0.5f;
-		block[i] = sample * 2;
-		currentAngle += angleDelta;
-	}
+void Oscillators::Triangle::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	phase.fill(frequencies, sampleRate, blockSize, block);
+	shape(frequencies, blockSize, block);
 }
 
-void Oscillators::Triangle::writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) {
-	updateAngleDelta(frequency);
-	for (unsigned i = 0; i < blockSize; i++) {
-		float mod = std::fmod(currentAngle, 2.0f) - 1.0f;
-		float sample = (mod < 0.0f) ? mod + 0.5f : (1.0f - mod) - 0.5f;
-		block[i] = sample * 2 * amplitude;
-		currentAngle += angleDelta;
+void Oscillators::Triangle::renderPoints(const float* frequencies, const unsigned& stride, const unsigned& numPoints, float* points) {
+	// Each point moves the phase on by stride samples at its pitch
+	phase.fill(frequencies, (double)sampleRate / stride, numPoints, points);
+	shape(frequencies, numPoints, points);
+}
+
+void Oscillators::Triangle::shape(const float* frequencies, const unsigned& blockSize, float* block) {
+	if (antialiasing == Oscillators::Antialiasing::POLYBLEP) {
+		const Simd::Float inverseSampleRate = Simd::set(1.0f / sampleRate);
+		Simd::transform(blockSize, block, frequencies, [&](const Simd::Float& phases, const Simd::Float& frequency) {
+			// A zero increment makes inverseDt infinite, but then neither polynomial branch is selected
+			Simd::Float dt = Simd::mul(Simd::abs(frequency), inverseSampleRate);
+			return antialiased(phases, dt, Simd::div(Simd::set(1.0f), dt));
+		});
+	}
+	else {
+		Simd::transform(blockSize, block, [](const Simd::Float& phases) { return Simd::triangle(phases); });
 	}
 }
\ No newline at end of file
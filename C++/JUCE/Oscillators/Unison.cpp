@@ -0,0 +1,265 @@
+#include <cmath>
+#include "Unison.h"
+#include "Simd.h"
+
+namespace {
+	using namespace Oscillators;
+
+	/// <summary>
+	/// Shapes evaluated for Simd::width voices at once, each with its own increment
+	/// </summary>
+	template <bool Antialiased>
+	struct SawShape {
+		static Simd::Float evaluate(const Simd::Float& phases, const Simd::Float& dt, const Simd::Float& inverseDt) {
+			Simd::Float naive = Simd::saw(phases);
+			return Antialiased ? Simd::sub(naive, Simd::polyBlep(phases, dt, inverseDt)) : naive;
+		}
+	};
+
+	template <bool Antialiased>
+	struct SquareShape {
+		static Simd::Float evaluate(const Simd::Float& phases, const Simd::Float& dt, const Simd::Float& inverseDt) {
+			Simd::Float naive = Simd::square(phases);
+			if (!Antialiased) {
+				return naive;
+			}
+			Simd::Float opposite = Simd::wrap(Simd::add(phases, Simd::set(0.5f)));
+			return Simd::add(Simd::sub(naive, Simd::polyBlep(phases, dt, inverseDt)), Simd::polyBlep(opposite, dt, inverseDt));
+		}
+	};
+
+	template <bool Antialiased>
+	struct TriangleShape {
+		static Simd::Float evaluate(const Simd::Float& phases, const Simd::Float& dt, const Simd::Float& inverseDt) {
+			Simd::Float naive = Simd::triangle(phases);
+			if (!Antialiased) {
+				return naive;
+			}
+			Simd::Float opposite = Simd::wrap(Simd::add(phases, Simd::set(0.5f)));
+			Simd::Float rounding = Simd::sub(Simd::polyBlamp(phases, dt, inverseDt), Simd::polyBlamp(opposite, dt, inverseDt));
+			return Simd::mulAdd(Simd::mul(Simd::set(4.0f), dt), rounding, naive);
+		}
+	};
+
+	struct SineShape {
+		static Simd::Float evaluate(const Simd::Float& phases, const Simd::Float&, const Simd::Float&) {
+			return Simd::sine(phases);
+		}
+	};
+
+	constexpr unsigned CHUNK = 64;
+
+	/// <summary>
+	/// xorshift32, enough to scatter start phases without touching the global generator
+	/// </summary>
+	float nextRandom(uint32_t& state) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return (float)(state >> 8) * (1.0f / 16777216.0f);
+	}
+};
+
+Oscillators::Unison::Unison(const Oscillators::Type& type, const float& sampleRate, const unsigned& numVoices) {
+	this->type = type;
+	this->sampleRate = sampleRate;
+	this->numVoices = numVoices;
+	updateVoices();
+	retrigger();
+}
+
+void Oscillators::Unison::setSampleRate(const float& sampleRate) {
+	this->sampleRate = sampleRate;
+}
+
+void Oscillators::Unison::setType(const Oscillators::Type& type) {
+	this->type = type;
+}
+
+void Oscillators::Unison::setAntialiasing(const Oscillators::Antialiasing& antialiasing) {
+	this->antialiasing = antialiasing;
+}
+
+void Oscillators::Unison::setNumVoices(const unsigned& numVoices) {
+	this->numVoices = numVoices;
+	updateVoices();
+}
+
+void Oscillators::Unison::setDetune(const float& cents) {
+	detune = cents;
+	updateVoices();
+}
+
+void Oscillators::Unison::setSpread(const float& spread) {
+	this->spread = spread;
+	updateVoices();
+}
+
+void Oscillators::Unison::setPhaseRandomization(const float& amount) {
+	phaseRandomization = amount;
+}
+
+void Oscillators::Unison::retrigger() {
+	resetPhase(0.0);
+}
+
+void Oscillators::Unison::resetPhase(const double& cycles) {
+	const float start = (float)(cycles - std::floor(cycles));
+	for (unsigned voice = 0; voice < MAX_VOICES; voice++) {
+		phases[voice] = start + phaseRandomization * nextRandom(seed);
+		phases[voice] -= std::floor(phases[voice]);
+	}
+}
+
+void Oscillators::Unison::updateVoices() {
+	jassert(numVoices >= 1 && numVoices <= MAX_VOICES);
+	numVoices = (numVoices < 1) ? 1 : ((numVoices > MAX_VOICES) ? MAX_VOICES : numVoices);
+
+	const float level = 1.0f / std::sqrt((float)numVoices);
+	for (unsigned voice = 0; voice < numVoices; voice++) {
+		// Offset in [-1, 1]; alternate the pan side so neighbouring pitches split left and right
+		float offset = (numVoices == 1) ? 0.0f : -1.0f + 2.0f * (float)voice / (float)(numVoices - 1);
+		float pan = spread * ((voice % 2 == 0) ? offset : -offset);
+		ratios[voice] = std::pow(2.0f, offset * detune / 1200.0f);
+
+		// Equal power pan, normalised so a centred voice keeps the mono level in both channels
+		float angle = (pan + 1.0f) * (float)(PI / 4.0);
+		monoGains[voice] = level;
+		leftGains[voice] = level * std::sqrt(2.0f) * std::cos(angle);
+		rightGains[voice] = level * std::sqrt(2.0f) * std::sin(angle);
+	}
+}
+
+void Oscillators::Unison::render(const float& frequency, const unsigned& blockSize, float* block) {
+	renderType<false, false>(&frequency, blockSize, [block](const unsigned& i, const float& left, const float&) {
+		block[i] = left;
+	});
+}
+
+void Oscillators::Unison::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	renderType<false, true>(frequencies, blockSize, [block](const unsigned& i, const float& left, const float&) {
+		block[i] = left;
+	});
+}
+
+void Oscillators::Unison::writeStereo(const float& frequency, const unsigned& blockSize, float* left, float* right) {
+	renderType<true, false>(&frequency, blockSize, [left, right](const unsigned& i, const float& leftSample, const float& rightSample) {
+		left[i] = leftSample;
+		right[i] = rightSample;
+	});
+}
+
+void Oscillators::Unison::writeStereo(const float* frequencies, const unsigned& blockSize, float* left, float* right) {
+	renderType<true, true>(frequencies, blockSize, [left, right](const unsigned& i, const float& leftSample, const float& rightSample) {
+		left[i] = leftSample;
+		right[i] = rightSample;
+	});
+}
+
+void Oscillators::Unison::writeStereo(const float& frequency, juce::AudioBuffer<float>& buffer) {
+	if (buffer.getNumChannels() == 0) {
+		return;
+	}
+	if (buffer.getNumChannels() == 1) {
+		writeBlock(frequency, (unsigned)buffer.getNumSamples(), buffer.getWritePointer(0));
+		return;
+	}
+	writeStereo(frequency, (unsigned)buffer.getNumSamples(), buffer.getWritePointer(0), buffer.getWritePointer(1));
+}
+
+void Oscillators::Unison::writeInterleaved(const float& frequency, const unsigned& blockSize, float* frames) {
+	renderType<true, false>(&frequency, blockSize, [frames](const unsigned& i, const float& left, const float& right) {
+		frames[2 * i] = left;
+		frames[2 * i + 1] = right;
+	});
+}
+
+template <bool Stereo, bool PerSample, typename Writer>
+void Oscillators::Unison::renderType(const float* frequencies, const unsigned& blockSize, const Writer& write) {
+	const bool antialiased = (antialiasing == Oscillators::Antialiasing::POLYBLEP);
+	switch (type) {
+	case(Oscillators::Type::SAW):
+		if (antialiased) renderVoices<SawShape<true>, Stereo, PerSample>(frequencies, blockSize, write);
+		else renderVoices<SawShape<false>, Stereo, PerSample>(frequencies, blockSize, write);
+		break;
+	case(Oscillators::Type::SQUARE):
+		if (antialiased) renderVoices<SquareShape<true>, Stereo, PerSample>(frequencies, blockSize, write);
+		else renderVoices<SquareShape<false>, Stereo, PerSample>(frequencies, blockSize, write);
+		break;
+	case(Oscillators::Type::TRIANGLE):
+		if (antialiased) renderVoices<TriangleShape<true>, Stereo, PerSample>(frequencies, blockSize, write);
+		else renderVoices<TriangleShape<false>, Stereo, PerSample>(frequencies, blockSize, write);
+		break;
+	default:
+		renderVoices<SineShape, Stereo, PerSample>(frequencies, blockSize, write);
+		break;
+	}
+}
+
+template <typename Shape, bool Stereo, bool PerSample, typename Writer>
+void Oscillators::Unison::renderVoices(const float* frequencies, const unsigned& blockSize, const Writer& write) {
+	const float inverseSampleRate = 1.0f / sampleRate;
+	const float* firstGains = Stereo ? leftGains : monoGains;
+
+	// Every voice runs at a fixed ratio of the same pitch, so the phase each voice has
+	// travelled is its ratio times one shared running sum: the sum is built once per
+	// chunk, and each voice is then vectorised along time with no carried dependency
+	alignas(64) float offsets[CHUNK];
+	alignas(64) float increments[CHUNK];
+	alignas(64) float firstChunk[CHUNK];
+	alignas(64) float secondChunk[CHUNK];
+
+	for (unsigned start = 0; start < blockSize; start += CHUNK) {
+		const unsigned count = (blockSize - start < CHUNK) ? blockSize - start : CHUNK;
+		const unsigned padded = (count + Simd::width - 1) / Simd::width * Simd::width;
+		float travelled = 0.0f;
+		for (unsigned i = 0; i < padded; i++) {
+			// Past count the last pitch is repeated, those lanes are computed but never written
+			float increment = (PerSample ? frequencies[start + ((i < count) ? i : count - 1)] : frequencies[0]) * inverseSampleRate;
+			offsets[i] = PerSample ? travelled : (float)i * increment;
+			increments[i] = increment;
+			travelled += increment;
+			firstChunk[i] = 0.0f;
+			secondChunk[i] = 0.0f;
+		}
+		if (!PerSample) {
+			travelled = (float)count * increments[0];
+		}
+		else {
+			travelled = offsets[count - 1] + increments[count - 1];
+		}
+
+		for (unsigned voice = 0; voice < numVoices; voice++) {
+			const Simd::Float phase = Simd::set(phases[voice]);
+			const Simd::Float ratio = Simd::set(ratios[voice]);
+			const Simd::Float firstGain = Simd::set(firstGains[voice]);
+			const Simd::Float secondGain = Simd::set(rightGains[voice]);
+			// A zero increment makes inverseDt infinite, but then neither polynomial branch is selected
+			const float delta = std::fabs(increments[0] * ratios[voice]);
+			const Simd::Float fixedDt = Simd::set(delta);
+			const Simd::Float fixedInverseDt = Simd::set(1.0f / delta);
+
+			for (unsigned i = 0; i < padded; i += Simd::width) {
+				Simd::Float current = Simd::wrap(Simd::mulAdd(Simd::load(offsets + i), ratio, phase));
+				Simd::Float sample;
+				if (PerSample) {
+					Simd::Float dt = Simd::abs(Simd::mul(Simd::load(increments + i), ratio));
+					sample = Shape::evaluate(current, dt, Simd::div(Simd::set(1.0f), dt));
+				}
+				else {
+					sample = Shape::evaluate(current, fixedDt, fixedInverseDt);
+				}
+				Simd::store(firstChunk + i, Simd::mulAdd(sample, firstGain, Simd::load(firstChunk + i)));
+				if (Stereo) {
+					Simd::store(secondChunk + i, Simd::mulAdd(sample, secondGain, Simd::load(secondChunk + i)));
+				}
+			}
+			phases[voice] += travelled * ratios[voice];
+			phases[voice] -= std::floor(phases[voice]);
+		}
+
+		for (unsigned i = 0; i < count; i++) {
+			write(start + i, firstChunk[i], secondChunk[i]);
+		}
+	}
+}
@@ -0,0 +1,147 @@
+#ifndef LOTKEY_CPP_JUCE_UNISON_H
+#define LOTKEY_CPP_JUCE_UNISON_H
+
+#include <cstdint>
+#include "Oscillators.h"
+
+/// <summary>
+/// Stack of detuned copies of one shape (supersaw and friends) rendered in a single pass.
+/// Every voice runs at a fixed ratio of one pitch, so the phase they travel is built once per
+/// chunk and each voice is then vectorised along time straight into the mix: no virtual call,
+/// phase buffer or carried dependency per voice, and stereo costs one extra multiply-add.
+/// Voice offsets are spread evenly over [-detune, +detune] cents; neighbouring offsets
+/// are panned to opposite sides so the stereo image does not sort by pitch.
+/// Nothing allocates: every voice lives in fixed arrays of MAX_VOICES.
+/// </summary>
+class Oscillators::Unison : public Oscillators::Oscillator {
+public:
+	/// <summary>
+	/// Largest number of voices in the stack
+	/// </summary>
+	static constexpr unsigned MAX_VOICES = 16;
+private:
+	Oscillators::Type type = Oscillators::Type::SAW;
+	Oscillators::Antialiasing antialiasing = Oscillators::Antialiasing::POLYBLEP;
+	float sampleRate = 48000;
+	unsigned numVoices = 7;
+	float detune = 25.0f;
+	float spread = 1.0f;
+	float phaseRandomization = 1.0f;
+	uint32_t seed = 0x9E3779B9u;
+
+	float phases[MAX_VOICES] = {};
+	float ratios[MAX_VOICES] = {};
+	float monoGains[MAX_VOICES] = {};
+	float leftGains[MAX_VOICES] = {};
+	float rightGains[MAX_VOICES] = {};
+
+	void updateVoices();
+	template <bool Stereo, bool PerSample, typename Writer>
+	void renderType(const float* frequencies, const unsigned& blockSize, const Writer& write);
+	template <typename Shape, bool Stereo, bool PerSample, typename Writer>
+	void renderVoices(const float* frequencies, const unsigned& blockSize, const Writer& write);
+protected:
+	/// <summary>
+	/// Render the mono sum of the stack for the next block
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	/// <summary>
+	/// Render the mono sum of the stack for the next block with a pitch per sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
+public:
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	/// <param name="type"> - shape of every voice </param>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	/// <param name="numVoices"> - number of voices, 1 to MAX_VOICES </param>
+	Unison(const Oscillators::Type& type, const float& sampleRate, const unsigned& numVoices = 7);
+	/// <summary>
+	/// Set the sample rate of the oscillator
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) override;
+	/// <summary>
+	/// Set the shape of every voice
+	/// </summary>
+	/// <param name="type"> - new shape </param>
+	void setType(const Oscillators::Type& type);
+	/// <summary>
+	/// Set the anti-aliasing mode of every voice, see Saw::setAntialiasing
+	/// </summary>
+	/// <param name="antialiasing"> - new anti-aliasing mode </param>
+	void setAntialiasing(const Oscillators::Antialiasing& antialiasing);
+	/// <summary>
+	/// Set the number of voices. The level is scaled by 1 / sqrt(numVoices) so
+	/// the loudness stays about the same. Voices keep their phases.
+	/// </summary>
+	/// <param name="numVoices"> - number of voices, 1 to MAX_VOICES </param>
+	void setNumVoices(const unsigned& numVoices);
+	/// <summary>
+	/// Get the number of voices
+	/// </summary>
+	unsigned getNumVoices() const { return numVoices; }
+	/// <summary>
+	/// Set the detune of the outermost voices
+	/// </summary>
+	/// <param name="cents"> - offset (cents) of the highest voice, the lowest is offset by -cents </param>
+	void setDetune(const float& cents);
+	/// <summary>
+	/// Set the stereo width. At 0 both channels carry the mono sum; at 1 the outermost voices are panned hard.
+	/// </summary>
+	/// <param name="spread"> - width [0, 1] </param>
+	void setSpread(const float& spread);
+	/// <summary>
+	/// Set how far retrigger scatters the start phases. 0 starts every voice at
+	/// phase 0 (a hard, phasey attack), 1 scatters them over the whole cycle.
+	/// </summary>
+	/// <param name="amount"> - randomization [0, 1] </param>
+	void setPhaseRandomization(const float& amount);
+	/// <summary>
+	/// Restart every voice at a new start phase, see setPhaseRandomization. Call on note on.
+	/// </summary>
+	void retrigger();
+	/// <summary>
+	/// Restart every voice at a phase, scattered around it as retrigger does
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override;
+	/// <summary>
+	/// Write the next block as planar stereo
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="left"> - float* to write the left channel to </param>
+	/// <param name="right"> - float* to write the right channel to </param>
+	void writeStereo(const float& frequency, const unsigned& blockSize, float* left, float* right);
+	/// <summary>
+	/// Write the next block as planar stereo with a pitch per sample
+	/// </summary>
+	/// <param name="frequencies"> - pitch (Hz) of each sample </param>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="left"> - float* to write the left channel to </param>
+	/// <param name="right"> - float* to write the right channel to </param>
+	void writeStereo(const float* frequencies, const unsigned& blockSize, float* left, float* right);
+	/// <summary>
+	/// Write the next block to the first two channels of a buffer, or the mono sum if it has one channel
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="buffer"> - buffer to write to </param>
+	void writeStereo(const float& frequency, juce::AudioBuffer<float>& buffer);
+	/// <summary>
+	/// Write the next block as interleaved stereo (left, right, left, ...)
+	/// </summary>
+	/// <param name="frequency"> - pitch (Hz) of the entire block </param>
+	/// <param name="blockSize"> - number of frames to write </param>
+	/// <param name="frames"> - float* to write 2 * blockSize samples to </param>
+	void writeInterleaved(const float& frequency, const unsigned& blockSize, float* frames);
+};
+
+#endif
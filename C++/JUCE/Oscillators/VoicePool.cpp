@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cmath>
+#include "VoicePool.h"
+
+Oscillators::VoicePool::VoicePool(const unsigned& voicesPerType, const float& sampleRate, const Oscillators::Antialiasing& antialiasing) {
+	this->voicesPerType = voicesPerType;
+	saws.reserve(voicesPerType);
+	squares.reserve(voicesPerType);
+	sines.reserve(voicesPerType);
+	triangles.reserve(voicesPerType);
+	theremins.reserve(voicesPerType);
+	for (unsigned voice = 0; voice < voicesPerType; voice++) {
+		saws.push_back({ Oscillators::Saw(sampleRate, antialiasing) });
+		squares.push_back({ Oscillators::Square(sampleRate, antialiasing) });
+		sines.push_back({ Oscillators::Sine(sampleRate, Oscillators::Accuracy::MINUS_120_DB) });
+		triangles.push_back({ Oscillators::Triangle(sampleRate, antialiasing) });
+		theremins.push_back({ Oscillators::Theremin(sampleRate) });
+	}
+
+	// Ids run through the types in getTypeIndex order
+	for (auto& slot : saws) {
+		oscillators.push_back(&slot.oscillator);
+	}
+	for (auto& slot : squares) {
+		oscillators.push_back(&slot.oscillator);
+	}
+	for (auto& slot : sines) {
+		oscillators.push_back(&slot.oscillator);
+	}
+	for (auto& slot : triangles) {
+		oscillators.push_back(&slot.oscillator);
+	}
+	for (auto& slot : theremins) {
+		oscillators.push_back(&slot.oscillator);
+	}
+
+	for (unsigned type = 0; type < NUM_TYPES; type++) {
+		freeVoices[type].reserve(voicesPerType);
+		// Pushed in reverse so the lowest id is handed out first
+		for (unsigned voice = voicesPerType; voice-- > 0;) {
+			freeVoices[type].push_back(type * voicesPerType + voice);
+		}
+	}
+	active.reserve(oscillators.size());
+	positions = std::vector<unsigned>(oscillators.size(), NO_VOICE);
+}
+
+unsigned Oscillators::VoicePool::getTypeIndex(const Oscillators::Type& type) {
+	switch (type) {
+	case(Oscillators::Type::SAW):
+		return 0;
+	case(Oscillators::Type::SQUARE):
+		return 1;
+	case(Oscillators::Type::SINE):
+		return 2;
+	case(Oscillators::Type::TRIANGLE):
+		return 3;
+	case(Oscillators::Type::THEREMIN):
+		return 4;
+	default:
+		return NUM_TYPES;
+	}
+}
+
+void Oscillators::VoicePool::setSampleRate(const float& sampleRate) {
+	for (Oscillators::Oscillator* oscillator : oscillators) {
+		oscillator->setSampleRate(sampleRate);
+	}
+}
+
+void Oscillators::VoicePool::setStealing(const Oscillators::VoiceStealing& stealing) {
+	this->stealing = stealing;
+}
+
+unsigned Oscillators::VoicePool::findVictim(const Oscillators::Type& type, const int& note) const {
+	unsigned victim = NO_VOICE;
+	for (unsigned i = 0; i < active.size(); i++) {
+		const Voice& voice = active[i];
+		if (voice.type != type) {
+			continue;
+		}
+		if (victim == NO_VOICE) {
+			victim = i;
+			continue;
+		}
+		const Voice& best = active[victim];
+		bool better = false;
+		switch (stealing) {
+		case(Oscillators::VoiceStealing::QUIETEST):
+			better = std::fabs(voice.amplitude) < std::fabs(best.amplitude);
+			break;
+		case(Oscillators::VoiceStealing::SAME_NOTE):
+			// The same note wins outright, then the oldest
+			better = (voice.note == note) != (best.note == note) ? voice.note == note : voice.started < best.started;
+			break;
+		default:
+			better = voice.started < best.started;
+			break;
+		}
+		if (better) {
+			victim = i;
+		}
+	}
+	return victim;
+}
+
+unsigned Oscillators::VoicePool::noteOn(const Oscillators::Type& type, const int& note, const float& frequency, const float& amplitude) {
+	const unsigned typeIndex = getTypeIndex(type);
+	if (typeIndex >= NUM_TYPES || voicesPerType == 0) {
+		jassertfalse;
+		return NO_VOICE;
+	}
+
+	unsigned position = NO_VOICE;
+	if (stealing == Oscillators::VoiceStealing::SAME_NOTE) {
+		const unsigned candidate = findVictim(type, note);
+		if (candidate != NO_VOICE && active[candidate].note == note) {
+			position = candidate;
+		}
+	}
+	if (position == NO_VOICE) {
+		std::vector<unsigned>& free = freeVoices[typeIndex];
+		if (!free.empty()) {
+			const unsigned id = free.back();
+			free.pop_back();
+			position = (unsigned)active.size();
+			positions[id] = position;
+			active.push_back({});
+			active[position].id = id;
+			active[position].oscillator = oscillators[id];
+			active[position].type = type;
+		}
+		else {
+			position = findVictim(type, note);
+		}
+	}
+
+	Voice& voice = active[position];
+	voice.note = note;
+	voice.frequency = frequency;
+	voice.amplitude = amplitude;
+	voice.started = nextStart++;
+	voice.oscillator->resetPhase(0.0);
+	return voice.id;
+}
+
+unsigned Oscillators::VoicePool::noteOff(const int& note) {
+	unsigned released = 0;
+	// Walk backwards so the voice swapped into a hole has already been checked
+	for (unsigned i = (unsigned)active.size(); i-- > 0;) {
+		if (active[i].note == note) {
+			release(active[i].id);
+			released++;
+		}
+	}
+	return released;
+}
+
+void Oscillators::VoicePool::release(const unsigned& id) {
+	if (!isActive(id)) {
+		return;
+	}
+	const unsigned position = positions[id];
+	const Voice voice = active[position];
+
+	// Move the last voice into the hole so the sounding voices stay packed
+	active[position] = active.back();
+	positions[active[position].id] = position;
+	active.pop_back();
+	positions[id] = NO_VOICE;
+
+	freeVoices[getTypeIndex(voice.type)].push_back(id);
+}
+
+void Oscillators::VoicePool::releaseAll() {
+	while (!active.empty()) {
+		release(active.back().id);
+	}
+}
+
+void Oscillators::VoicePool::setVoice(const unsigned& id, const float& frequency, const float& amplitude) {
+	if (!isActive(id)) {
+		jassertfalse;
+		return;
+	}
+	Voice& voice = active[positions[id]];
+	voice.frequency = frequency;
+	voice.amplitude = amplitude;
+}
+
+void Oscillators::VoicePool::process(const unsigned& blockSize, float* block) {
+	std::fill(block, block + blockSize, 0.0f);
+	for (const Voice& voice : active) {
+		voice.oscillator->addBlock(voice.frequency, blockSize, voice.amplitude, block);
+	}
+}
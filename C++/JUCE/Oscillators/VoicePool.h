@@ -0,0 +1,149 @@
+#ifndef LOTKEY_CPP_JUCE_VOICEPOOL_H
+#define LOTKEY_CPP_JUCE_VOICEPOOL_H
+
+#include <cstdint>
+#include <vector>
+#include "Oscillators.h"
+
+/// <summary>
+/// Fixed set of preallocated voices handed out on note on, so nothing is built or
+/// allocated on the audio thread.
+/// Every Type with an oscillator class gets the same number of voices, stored contiguously
+/// per type in slots aligned to and padded to whole cache lines, so neighbouring voices never share a line.
+/// Free voices of each type sit on a stack: note on and release are O(1). When a type runs
+/// out, a sounding voice is stolen following the VoiceStealing policy.
+/// The sounding voices are kept packed at the front of one array (release swaps the last
+/// voice into the hole), so process, or any render loop over getActiveVoices, reads them linearly.
+/// </summary>
+class Oscillators::VoicePool {
+public:
+	/// <summary>
+	/// Returned by noteOn when no voice could be found
+	/// </summary>
+	static constexpr unsigned NO_VOICE = ~0u;
+
+	/// <summary>
+	/// A sounding voice
+	/// </summary>
+	struct Voice {
+		Oscillators::Oscillator* oscillator = nullptr;
+		Oscillators::Type type = Oscillators::Type::SINE;
+		// Handle of the voice, stable while it sounds
+		unsigned id = NO_VOICE;
+		int note = 0;
+		float frequency = 0.0f;
+		float amplitude = 0.0f;
+		// Note on order, for OLDEST
+		uint64_t started = 0;
+	};
+private:
+	/// <summary>
+	/// One oscillator padded to its own cache lines
+	/// </summary>
+	template <typename T>
+	struct alignas(64) Slot {
+		T oscillator;
+	};
+
+	static constexpr unsigned NUM_TYPES = 5;
+
+	unsigned voicesPerType = 0;
+	Oscillators::VoiceStealing stealing = Oscillators::VoiceStealing::OLDEST;
+	uint64_t nextStart = 0;
+
+	std::vector<Slot<Oscillators::Saw>> saws;
+	std::vector<Slot<Oscillators::Square>> squares;
+	std::vector<Slot<Oscillators::Sine>> sines;
+	std::vector<Slot<Oscillators::Triangle>> triangles;
+	std::vector<Slot<Oscillators::Theremin>> theremins;
+	// Every oscillator by id; ids run through the types in the order above
+	std::vector<Oscillators::Oscillator*> oscillators;
+
+	// Per type stack of free ids
+	std::vector<unsigned> freeVoices[NUM_TYPES];
+	// Sounding voices, packed; positions[id] is where a voice sits in it, or NO_VOICE
+	std::vector<Voice> active;
+	std::vector<unsigned> positions;
+
+	static unsigned getTypeIndex(const Oscillators::Type& type);
+	unsigned findVictim(const Oscillators::Type& type, const int& note) const;
+public:
+	/// <summary>
+	/// Constructor. Allocates every voice, so call off the audio thread.
+	/// Sine voices use the MINUS_120_DB polynomial.
+	/// </summary>
+	/// <param name="voicesPerType"> - voices of each of SAW, SQUARE, SINE, TRIANGLE and THEREMIN </param>
+	/// <param name="sampleRate"> - sample rate (Hz) </param>
+	/// <param name="antialiasing"> - anti-aliasing of the saw, square and triangle voices </param>
+	VoicePool(const unsigned& voicesPerType, const float& sampleRate, const Oscillators::Antialiasing& antialiasing = Oscillators::Antialiasing::POLYBLEP);
+	VoicePool(const VoicePool&) = delete;
+	VoicePool& operator=(const VoicePool&) = delete;
+	/// <summary>
+	/// Set the sample rate of every voice
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate);
+	/// <summary>
+	/// Set which voice is taken over when a type runs out
+	/// </summary>
+	/// <param name="stealing"> - stealing policy, OLDEST by default </param>
+	void setStealing(const Oscillators::VoiceStealing& stealing);
+	/// <summary>
+	/// Start a note on a free voice of a type, or on a stolen one. The voice restarts at phase 0.
+	/// Stealing, and SAME_NOTE looking for the note, scan the sounding voices; everything else is O(1).
+	/// </summary>
+	/// <param name="type"> - shape of the voice </param>
+	/// <param name="note"> - note number, used by SAME_NOTE and noteOff </param>
+	/// <param name="frequency"> - pitch (Hz) </param>
+	/// <param name="amplitude"> - amplitude, used by QUIETEST </param>
+	/// <returns> id of the voice, or NO_VOICE if the type has no voices </returns>
+	unsigned noteOn(const Oscillators::Type& type, const int& note, const float& frequency, const float& amplitude);
+	/// <summary>
+	/// Release every voice playing a note
+	/// </summary>
+	/// <param name="note"> - note number </param>
+	/// <returns> number of voices released </returns>
+	unsigned noteOff(const int& note);
+	/// <summary>
+	/// Return a voice to its free list
+	/// </summary>
+	/// <param name="id"> - id from noteOn; ignored if the voice is not sounding </param>
+	void release(const unsigned& id);
+	/// <summary>
+	/// Release every voice
+	/// </summary>
+	void releaseAll();
+	/// <summary>
+	/// Check whether a voice is sounding. A stolen voice sounds again under its new note.
+	/// </summary>
+	/// <param name="id"> - id from noteOn </param>
+	bool isActive(const unsigned& id) const { return id < positions.size() && positions[id] != NO_VOICE; }
+	/// <summary>
+	/// Set the pitch and amplitude of a sounding voice, e.g. from its envelope.
+	/// QUIETEST compares the amplitudes set here.
+	/// </summary>
+	/// <param name="id"> - id of a sounding voice </param>
+	/// <param name="frequency"> - pitch (Hz) </param>
+	/// <param name="amplitude"> - amplitude </param>
+	void setVoice(const unsigned& id, const float& frequency, const float& amplitude);
+	/// <summary>
+	/// Get the sounding voices, packed
+	/// </summary>
+	const Voice* getActiveVoices() const { return active.data(); }
+	/// <summary>
+	/// Get the number of sounding voices
+	/// </summary>
+	unsigned getNumActive() const { return (unsigned)active.size(); }
+	/// <summary>
+	/// Get the number of voices of each type
+	/// </summary>
+	unsigned getVoicesPerType() const { return voicesPerType; }
+	/// <summary>
+	/// Write the mix of every sounding voice at its pitch and amplitude
+	/// </summary>
+	/// <param name="blockSize"> - size of the block to write </param>
+	/// <param name="block"> - float* to write to </param>
+	void process(const unsigned& blockSize, float* block);
+};
+
+#endif
@@ -1,140 +1,239 @@
-#include <fstream>
+#include <cmath>
 #include "Wavetable.h"
+#include "Simd.h"
 
-Oscillators::Wavetable::Wavetable() {
-	table = Oscillators::Wavetables::getWavetable(Oscillators::Type::SINE, WAVETABLE_SIZE);
-}
+Oscillators::Wavetable::Wavetable() : Wavetable(Oscillators::Type::SINE) {}
+
+Oscillators::Wavetable::Wavetable(const Oscillators::Type& type) : Wavetable(Oscillators::Wavetables::getSharedMipMap(type, WAVETABLE_SIZE)) {}
 
-Oscillators::Wavetable::Wavetable(const Oscillators::Type& type) {
-	table = Oscillators::Wavetables::getWavetable(type, WAVETABLE_SIZE);
+Oscillators::Wavetable::Wavetable(const std::shared_ptr<const Oscillators::Wavetables::MipMap>& mipMap) {
+	// No renderer yet, so the table can be installed directly
+	published.push_back(mipMap);
+	this->mipMap = published.back().get();
+	installedMipMap = this->mipMap;
 }
 
 void Oscillators::Wavetable::setWavetable(const Oscillators::Type& type) {
-	table = Oscillators::Wavetables::getWavetable(type, WAVETABLE_SIZE);
+	setMipMap(Oscillators::Wavetables::getSharedMipMap(type, WAVETABLE_SIZE));
 }
 
-void Oscillators::Wavetable::updateAngleDelta(const double& frequency) {
-	auto tableSizeOverSampleRate = (float)table.size() / sampleRate;
-	tableDelta = frequency * tableSizeOverSampleRate;
-}
+void Oscillators::Wavetable::setMipMap(const std::shared_ptr<const Oscillators::Wavetables::MipMap>& mipMap) {
+	collectRetired();
+	published.push_back(mipMap);
 
-void Oscillators::Wavetable::setSampleRate(const float& sampleRate) {
-	this->sampleRate = sampleRate;
+	// A table still pending was never seen by the renderer and can go straight away
+	const Oscillators::Wavetables::MipMap* unused = pendingMipMap.exchange(mipMap.get(), std::memory_order_acq_rel);
+	if (unused) {
+		release(unused);
+	}
 }
 
-float* Oscillators::Wavetable::getBlock(const float& frequency, const unsigned& blockSize) {
-	updateDelta(frequency);
-	float* block = new float[blockSize];
-	
-	if (table.size() == 0) {
-		for (unsigned i = 0; i < blockSize; i++) {
-			block[i] = 0;
-		}
+void Oscillators::Wavetable::collectRetired() {
+	const Oscillators::Wavetables::MipMap* old = nullptr;
+	while (retired.pop(old)) {
+		release(old);
 	}
-	else {
-		for (unsigned i = 0; i < blockSize; i++) {
-			auto index0 = (unsigned int)currentIndex;
-			auto index1 = (index0 + 1) % table.size();
-
-			auto frac = currentIndex - (float)index0;
-			auto value0 = table[index0];
-			auto value1 = table[index1];
-
-			auto currentSample = value0 + frac * (value1 - value0);
-
-			if ((currentSample += tableDelta) > (float)table.size()) {
-				currentIndex -= (float)table.size();
-			}
+}
 
-			block[i] = currentSample;
+void Oscillators::Wavetable::release(const Oscillators::Wavetables::MipMap* mipMap) {
+	// Drop one reference; the same table may have been published more than once
+	for (auto it = published.begin(); it != published.end(); ++it) {
+		if (it->get() == mipMap) {
+			published.erase(it);
+			return;
 		}
 	}
-	return block;
 }
 
-float* Oscillators::Wavetable::getBlock(const float& frequency, const unsigned& blockSize, const float& volume) {
-	updateDelta(frequency);
-	float* block = new float[blockSize];
+void Oscillators::Wavetable::pushCommand(const Command& command) {
+	if (!commands.push(command)) {
+		// The renderer has not drained the queue for 64 changes; the change is lost
+		jassertfalse;
+	}
+}
 
-	if (table.size() == 0) {
-		for (unsigned i = 0; i < blockSize; i++) {
-			block[i] = 0;
+void Oscillators::Wavetable::applyChanges() {
+	Command command;
+	while (commands.pop(command)) {
+		if (command.kind == Command::Kind::SAMPLE_RATE) {
+			sampleRate = command.sampleRate;
+		}
+		else if (command.kind == Command::Kind::CROSSFADE) {
+			crossfade = command.crossfade;
+		}
+		else {
+			interpolation = command.interpolation;
 		}
 	}
-	else {
-		for (unsigned i = 0; i < blockSize; i++) {
-			auto index0 = (unsigned int)currentIndex;
-			auto index1 = (index0 + 1) % table.size();
-
-			auto frac = currentIndex - (float)index0;
-			auto value0 = table[index0];
-			auto value1 = table[index1];
 
-			auto currentSample = value0 + frac * (value1 - value0);
-
-			if ((currentSample += tableDelta) > (float)table.size()) {
-				currentIndex -= (float)table.size();
-			}
-
-			block[i] = currentSample * volume;
+	const Oscillators::Wavetables::MipMap* incoming = pendingMipMap.exchange(nullptr, std::memory_order_acq_rel);
+	if (incoming) {
+		// If the control thread has stopped collecting, the old table just stays in published
+		if (installedMipMap) {
+			retired.push(installedMipMap);
+		}
+		installedMipMap = incoming;
+		mipMap = incoming;
+		if (mipMap->levels.empty() || currentIndex >= (float)mipMap->levels[0].size) {
+			currentIndex = 0;
 		}
 	}
+}
+
+void Oscillators::Wavetable::updateAngleDelta(const double& frequency) {
+	const unsigned size = (mipMap && !mipMap->levels.empty()) ? mipMap->levels[0].size : 0;
+	auto tableSizeOverSampleRate = (float)size / sampleRate;
+	tableDelta = frequency * tableSizeOverSampleRate;
+}
 
-	return block;
+void Oscillators::Wavetable::setSampleRate(const float& sampleRate) {
+	Command command{};
+	command.kind = Command::Kind::SAMPLE_RATE;
+	command.sampleRate = sampleRate;
+	pushCommand(command);
 }
 
-void Oscillators::Wavetable::writeBlock(const float& frequency, const unsigned& blockSize, const float* block) {
-	updateDelta(frequency);
+void Oscillators::Wavetable::resetPhase(const double& cycles) {
+	const unsigned size = (mipMap && !mipMap->levels.empty()) ? mipMap->levels[0].size : 0;
+	currentIndex = (float)((cycles - std::floor(cycles)) * size);
+	if (currentIndex >= (float)size) {
+		currentIndex = 0;
+	}
+}
 
-	if (table.size() == 0) {
-		for (unsigned i = 0; i < blockSize; i++) {
-			block[i] = 0;
-		}
+void Oscillators::Wavetable::changeTable(const Oscillators::Wavetables::MipMap* mipMap) {
+	const Oscillators::Wavetables::MipMap* next = mipMap ? mipMap : installedMipMap;
+	const unsigned oldSize = (this->mipMap && !this->mipMap->levels.empty()) ? this->mipMap->levels[0].size : 0;
+	const unsigned newSize = (next && !next->levels.empty()) ? next->levels[0].size : 0;
+	// Keep the phase, which is counted in level 0 samples of the table being read
+	currentIndex = (oldSize > 0 && newSize > 0) ? currentIndex * (float)newSize / (float)oldSize : 0.0f;
+	if (currentIndex >= (float)newSize) {
+		currentIndex = 0;
 	}
-	else {
-		for (unsigned i = 0; i < blockSize; i++) {
-			auto index0 = (unsigned int)currentIndex;
-			auto index1 = (index0 + 1) % table.size();
+	this->mipMap = next;
+}
 
-			auto frac = currentIndex - (float)index0;
-			auto value0 = table[index0];
-			auto value1 = table[index1];
+void Oscillators::Wavetable::setInterpolation(const Oscillators::InterpolationMode& interpolation) {
+	Command command{};
+	command.kind = Command::Kind::INTERPOLATION;
+	command.interpolation = interpolation;
+	pushCommand(command);
+}
 
-			auto currentSample = value0 + frac * (value1 - value0);
+void Oscillators::Wavetable::setCrossfade(const bool& crossfade) {
+	Command command{};
+	command.kind = Command::Kind::CROSSFADE;
+	command.crossfade = crossfade;
+	pushCommand(command);
+}
 
-			if ((currentSample += tableDelta) > (float)table.size()) {
-				currentIndex -= (float)table.size();
-			}
+void Oscillators::Wavetable::render(const float& frequency, const unsigned& blockSize, float* block) {
+	applyChanges();
+	updateAngleDelta(frequency);
+	renderBlock(std::fabs(tableDelta), nullptr, 0.0f, blockSize, block);
+}
 
-			block[i] = currentSample;
-		}
+void Oscillators::Wavetable::render(const float* frequencies, const unsigned& blockSize, float* block) {
+	applyChanges();
+	const unsigned size = (mipMap && !mipMap->levels.empty()) ? mipMap->levels[0].size : 0;
+	const float deltaScale = (float)size / (float)sampleRate;
+
+	// The fastest sample picks the mip level, so the whole block stays alias-free
+	float maxFrequency = 0.0f;
+	for (unsigned i = 0; i < blockSize; i++) {
+		maxFrequency = std::fmax(maxFrequency, std::fabs(frequencies[i]));
 	}
+	renderBlock(maxFrequency * deltaScale, frequencies, deltaScale, blockSize, block);
 }
 
-void Oscillators::Wavetable::writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) {
-	updateDelta(frequency);
-
-	if (table.size() == 0) {
+void Oscillators::Wavetable::renderBlock(const float& maxDelta, const float* frequencies, const float& deltaScale, const unsigned& blockSize, float* block) {
+	if (!mipMap || mipMap->levels.empty() || mipMap->levels[0].size == 0) {
 		for (unsigned i = 0; i < blockSize; i++) {
 			block[i] = 0;
 		}
+		return;
 	}
-	else {
-		for (unsigned i = 0; i < blockSize; i++) {
-			auto index0 = (unsigned int)currentIndex;
-			auto index1 = (index0 + 1) % table.size();
 
-			auto frac = currentIndex - (float)index0;
-			auto value0 = table[index0];
-			auto value1 = table[index1];
+	const auto& levels = mipMap->levels;
+	const unsigned numLevels = (unsigned)levels.size();
+	const unsigned level = Oscillators::Wavetables::getLevel(*mipMap, maxDelta);
 
-			auto currentSample = value0 + frac * (value1 - value0);
+	// Positions first, since each depends on the last; then interpolate them all with Simd
+	if (frequencies) {
+		advancePositions<true>(frequencies, deltaScale, blockSize, block);
+	}
+	else {
+		advancePositions<false>(nullptr, 0.0f, blockSize, block);
+	}
 
-			if ((currentSample += tableDelta) > (float)table.size()) {
-				currentIndex -= (float)table.size();
-			}
+	const auto& table0 = levels[level];
+	if (crossfade && level + 1 < numLevels) {
+		// Fade towards the next level across the octave so the switch at its top is seamless
+		const float octave = (maxDelta > 0.0f) ? std::log2(maxDelta) : -1.0f;
+		float weight = octave - ((float)level - 1.0f);
+		weight = (weight < 0.0f) ? 0.0f : ((weight > 1.0f) ? 1.0f : weight);
+		interpolate<true>(table0, levels[level + 1], weight, blockSize, block);
+	}
+	else {
+		interpolate<false>(table0, table0, 0.0f, blockSize, block);
+	}
+}
 
-			block[i] = currentSample * amplitude;
+template <bool PerSample>
+void Oscillators::Wavetable::advancePositions(const float* frequencies, const float& deltaScale, const unsigned& blockSize, float* positions) {
+	const float size = (float)mipMap->levels[0].size;
+	for (unsigned i = 0; i < blockSize; i++) {
+		positions[i] = currentIndex;
+
+		currentIndex += PerSample ? frequencies[i] * deltaScale : tableDelta;
+		if (currentIndex >= size || currentIndex < 0.0f) {
+			// Negative pitches and steps of more than a table wrap too
+			currentIndex -= size * std::floor(currentIndex / size);
+			if (currentIndex >= size || currentIndex < 0.0f) {
+				// A tiny negative index rounds up to size, a huge one loses its fraction
+				currentIndex = 0.0f;
+			}
 		}
 	}
+}
+
+template <bool Crossfade>
+void Oscillators::Wavetable::interpolate(const Oscillators::Wavetables::Table& table0, const Oscillators::Wavetables::Table& table1, const float& weight, const unsigned& blockSize, float* block) {
+	switch (interpolation) {
+	case(Oscillators::InterpolationMode::TRUNCATE):
+		interpolateLevels<Oscillators::Interpolation::None, Crossfade>(table0, table1, weight, blockSize, block);
+		break;
+	case(Oscillators::InterpolationMode::HERMITE):
+		interpolateLevels<Oscillators::Interpolation::Hermite, Crossfade>(table0, table1, weight, blockSize, block);
+		break;
+	case(Oscillators::InterpolationMode::LAGRANGE):
+		interpolateLevels<Oscillators::Interpolation::Lagrange, Crossfade>(table0, table1, weight, blockSize, block);
+		break;
+	case(Oscillators::InterpolationMode::OPTIMAL_2X):
+		interpolateLevels<Oscillators::Interpolation::Optimal2x, Crossfade>(table0, table1, weight, blockSize, block);
+		break;
+	default:
+		interpolateLevels<Oscillators::Interpolation::Linear, Crossfade>(table0, table1, weight, blockSize, block);
+		break;
+	}
+}
+
+template <typename Interp, bool Crossfade>
+void Oscillators::Wavetable::interpolateLevels(const Oscillators::Wavetables::Table& table0, const Oscillators::Wavetables::Table& table1, const float& weight, const unsigned& blockSize, float* block) {
+	// Positions count level 0 samples; smaller levels are read at a proportional position
+	const float size = (float)mipMap->levels[0].size;
+	const Simd::Float scale0 = Simd::set((float)table0.size / size);
+	const Simd::Float scale1 = Simd::set((float)table1.size / size);
+	const Simd::Float weights = Simd::set(weight);
+	const float* samples0 = table0.samples.get();
+	const float* samples1 = table1.samples.get();
+
+	Simd::transform(blockSize, block, [&](const Simd::Float& position) {
+		Simd::Float sample = Interp::read(samples0, table0.size, Simd::mul(position, scale0));
+		if (Crossfade) {
+			Simd::Float next = Interp::read(samples1, table1.size, Simd::mul(position, scale1));
+			sample = Simd::mulAdd(weights, Simd::sub(next, sample), sample);
+		}
+		return sample;
+	});
 }
\ No newline at end of file
@@ -1,26 +1,116 @@
 #ifndef LOTKEY_CPP_JUCE_WAVETABLE_H
 #define LOTKEY_CPP_JUCE_WAVETABLE_H
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 #include "Oscillators.h"
 
+/// <summary>
+/// Band-limited wavetable oscillator.
+/// Each block reads the mip level whose harmonics stay below Nyquist at the
+/// requested pitch, optionally crossfading towards the next level.
+/// The setters are meant for one control thread while one audio thread renders:
+/// parameters travel through a lock-free queue and tables are swapped with an
+/// atomic pointer, so the renderer never waits. A replaced table is handed back
+/// to the control thread and released there, never on the audio thread.
+/// </summary>
 class Oscillators::Wavetable : public Oscillators::Oscillator {
 private:
+	struct Command {
+		enum class Kind { SAMPLE_RATE, CROSSFADE, INTERPOLATION } kind;
+		double sampleRate;
+		bool crossfade;
+		Oscillators::InterpolationMode interpolation;
+	};
+
+	// Audio thread state
 	double sampleRate = 48000;
 	float currentIndex = 0, tableDelta = 0;
-	std::vector<float> table;
+	bool crossfade = false;
+	Oscillators::InterpolationMode interpolation = Oscillators::InterpolationMode::LINEAR;
+	const Oscillators::Wavetables::MipMap* mipMap = nullptr;
+	// The table from setMipMap; mipMap differs from it while a caller's table is switched in
+	const Oscillators::Wavetables::MipMap* installedMipMap = nullptr;
+
+	// Control thread to audio thread
+	Oscillators::SpscQueue<Command, 64> commands;
+	std::atomic<const Oscillators::Wavetables::MipMap*> pendingMipMap{ nullptr };
+	// Audio thread to control thread: tables the renderer has stopped reading
+	Oscillators::SpscQueue<const Oscillators::Wavetables::MipMap*, 64> retired;
+	// Control thread: owns every table the renderer may still read
+	std::vector<std::shared_ptr<const Oscillators::Wavetables::MipMap>> published;
 
+	void pushCommand(const Command& command);
+	void release(const Oscillators::Wavetables::MipMap* mipMap);
+	void applyChanges();
 	void updateAngleDelta(const double& frequency);
+	void renderBlock(const float& maxDelta, const float* frequencies, const float& deltaScale, const unsigned& blockSize, float* block);
+	template <bool PerSample>
+	void advancePositions(const float* frequencies, const float& deltaScale, const unsigned& blockSize, float* positions);
+	template <bool Crossfade>
+	void interpolate(const Oscillators::Wavetables::Table& table0, const Oscillators::Wavetables::Table& table1, const float& weight, const unsigned& blockSize, float* block);
+	template <typename Interp, bool Crossfade>
+	void interpolateLevels(const Oscillators::Wavetables::Table& table0, const Oscillators::Wavetables::Table& table1, const float& weight, const unsigned& blockSize, float* block);
+protected:
+	void render(const float& frequency, const unsigned& blockSize, float* block) override;
+	void render(const float* frequencies, const unsigned& blockSize, float* block) override;
 public:
-	WavetableOscillator();
-	WavetableOscillator(const std::vector<float>& waveTable);
-	void setWavetable(const std::vector<float>& waveTable);
-	void setSampleRate(const float& sampleRate);
-	float* getBlock(const float& frequency, const unsigned& blockSize);
-	float* getBlock(const float& frequency, const unsigned& blockSize, const float& amplitude);
-	void writeBlock(const float& frequency, const unsigned& blockSize, const float* block) override;
-	void writeBlock(const float& frequency, const unsigned& blockSize, const float& amplitude, const float* block) override;
+	Wavetable();
+	Wavetable(const Oscillators::Type& type);
+	/// <summary>
+	/// Constructor from any mip-mapped table, e.g. a frame from Wavetables::loadWavetableFile
+	/// </summary>
+	/// <param name="mipMap"> - table to render from </param>
+	Wavetable(const std::shared_ptr<const Oscillators::Wavetables::MipMap>& mipMap);
+	Wavetable(const Wavetable&) = delete;
+	Wavetable& operator=(const Wavetable&) = delete;
+	/// <summary>
+	/// Swap in the shared table of a shape. Control thread; may build the table.
+	/// </summary>
+	/// <param name="type"> - shape of the table </param>
+	void setWavetable(const Oscillators::Type& type);
+	/// <summary>
+	/// Swap in any mip-mapped table. Control thread.
+	/// The renderer picks it up at its next block.
+	/// </summary>
+	/// <param name="mipMap"> - table to render from </param>
+	void setMipMap(const std::shared_ptr<const Oscillators::Wavetables::MipMap>& mipMap);
+	/// <summary>
+	/// Release the tables the renderer has stopped reading. Control thread.
+	/// The setters already do this; call it from a timer if tables change rarely.
+	/// </summary>
+	void collectRetired();
+	/// <summary>
+	/// Set the sample rate, applied at the start of the next block
+	/// </summary>
+	/// <param name="sampleRate"> - new sample rate </param>
+	void setSampleRate(const float& sampleRate) override;
+	/// <summary>
+	/// Restart the phase. Audio thread.
+	/// </summary>
+	/// <param name="cycles"> - phase to restart at, in cycles </param>
+	void resetPhase(const double& cycles) override;
+	/// <summary>
+	/// Read a table owned by the caller until the next changeTable, or until setMipMap
+	/// installs a new table. Audio thread; the phase carries over.
+	/// </summary>
+	/// <param name="mipMap"> - table to read, null to return to the table from setMipMap </param>
+	void changeTable(const Oscillators::Wavetables::MipMap* mipMap) override;
+	/// <summary>
+	/// Choose how the table is read between samples, applied at the start of the next block.
+	/// Better interpolation reaches the same noise floor with a smaller, cache-resident table.
+	/// </summary>
+	/// <param name="interpolation"> - interpolation, LINEAR by default </param>
+	void setInterpolation(const Oscillators::InterpolationMode& interpolation);
+	/// <summary>
+	/// Crossfade between the selected mip level and the next one down, so
+	/// brightness changes smoothly with pitch instead of stepping each octave.
+	/// Applied at the start of the next block.
+	/// </summary>
+	/// <param name="crossfade"> - true to crossfade </param>
+	void setCrossfade(const bool& crossfade);
 };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,22 @@
+#include <cctype>
 #include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
 #include <vector>
-#include "Wavetables.h"
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+#include "Oscillators.h"
 
 std::vector<float> Oscillators::Wavetables::sawTable(const unsigned& size) {
 	std::vector<float> table = std::vector<float>(size);
@@ -71,7 +87,541 @@ std::vector<float> Oscillators::Wavetables::getWavetable(const Oscillators::Type
 		return squareTable(size);
 	case(Oscillators::Type::TRIANGLE):
 		return triangleTable(size);
+	case(Oscillators::Type::THEREMIN):
+		// A theremin is a sine; its glide and vibrato live in Theremin
+		return sineTable(size);
 	default:
 		return sineTable(size);
 	}
+}
+
+namespace {
+	/// <summary>
+	/// One cycle as dc + sum of sines[h] * sin(2 pi h t) + cosines[h] * cos(2 pi h t), h from 1
+	/// </summary>
+	struct Harmonics {
+		double dc = 0.0;
+		std::vector<double> sines;
+		std::vector<double> cosines;
+
+		Harmonics(const unsigned& maxHarmonic) : sines(maxHarmonic + 1, 0.0), cosines(maxHarmonic + 1, 0.0) {}
+		unsigned getMaxHarmonic() const { return (unsigned)sines.size() - 1; }
+	};
+
+	/// <summary>
+	/// Table of size samples keeping the harmonics up to maxHarmonic (at most size / 2).
+	/// An inverse FFT for power-of-two sizes, a direct sum otherwise.
+	/// </summary>
+	std::vector<float> synthesise(const Harmonics& harmonics, const unsigned& size, const unsigned& maxHarmonic) {
+		std::vector<float> table = std::vector<float>(size, 0.0f);
+		if (size == 0) {
+			return table;
+		}
+		unsigned count = (maxHarmonic < harmonics.getMaxHarmonic()) ? maxHarmonic : harmonics.getMaxHarmonic();
+		count = (count < size / 2) ? count : size / 2;
+
+		if (Oscillators::Fft::isPowerOfTwo(size)) {
+			const unsigned half = size / 2;
+			std::vector<std::complex<double>> spectrum = std::vector<std::complex<double>>(half + 1, 0.0);
+			spectrum[0] = harmonics.dc * size;
+			for (unsigned harmonic = 1; harmonic <= count; harmonic++) {
+				// The sine of the Nyquist harmonic is zero at every sample
+				spectrum[harmonic] = (harmonic == half)
+					? std::complex<double>(harmonics.cosines[harmonic] * size, 0.0)
+					: std::complex<double>(harmonics.cosines[harmonic], -harmonics.sines[harmonic]) * (0.5 * size);
+			}
+			Oscillators::Fft fft(size);
+			fft.inverse(spectrum.data(), table.data());
+			return table;
+		}
+
+		// sin/cos of every table position, indexed by (harmonic * i) % size
+		std::vector<double> sines = std::vector<double>(size);
+		std::vector<double> cosines = std::vector<double>(size);
+		for (unsigned i = 0; i < size; i++) {
+			sines[i] = std::sin(2.0 * PI * i / size);
+			cosines[i] = std::cos(2.0 * PI * i / size);
+		}
+
+		std::vector<double> sum = std::vector<double>(size, harmonics.dc);
+		for (unsigned harmonic = 1; harmonic <= count; harmonic++) {
+			const double sineAmplitude = harmonics.sines[harmonic];
+			const double cosineAmplitude = harmonics.cosines[harmonic];
+			if (sineAmplitude == 0.0 && cosineAmplitude == 0.0) {
+				continue;
+			}
+			unsigned long long index = 0;
+			for (unsigned i = 0; i < size; i++) {
+				sum[i] += sineAmplitude * sines[index] + cosineAmplitude * cosines[index];
+				index = (index + harmonic) % size;
+			}
+		}
+
+		for (unsigned i = 0; i < size; i++) {
+			table[i] = (float)sum[i];
+		}
+		return table;
+	}
+
+	/// <summary>
+	/// Harmonics up to maxHarmonic (at most size / 2) of one cycle.
+	/// A forward FFT for power-of-two sizes, a direct DFT otherwise.
+	/// </summary>
+	Harmonics analyse(const float* samples, const unsigned& size, const unsigned& maxHarmonic) {
+		const unsigned count = (maxHarmonic < size / 2) ? maxHarmonic : size / 2;
+		Harmonics harmonics(count);
+		if (size == 0) {
+			return harmonics;
+		}
+
+		if (Oscillators::Fft::isPowerOfTwo(size)) {
+			const unsigned half = size / 2;
+			std::vector<std::complex<double>> spectrum = std::vector<std::complex<double>>(half + 1);
+			Oscillators::Fft fft(size);
+			fft.forward(samples, spectrum.data());
+			harmonics.dc = spectrum[0].real() / size;
+			for (unsigned harmonic = 1; harmonic <= count; harmonic++) {
+				const double scale = (harmonic == half) ? 1.0 / size : 2.0 / size;
+				harmonics.cosines[harmonic] = spectrum[harmonic].real() * scale;
+				harmonics.sines[harmonic] = (harmonic == half) ? 0.0 : -spectrum[harmonic].imag() * scale;
+			}
+			return harmonics;
+		}
+
+		std::vector<double> sines = std::vector<double>(size);
+		std::vector<double> cosines = std::vector<double>(size);
+		for (unsigned i = 0; i < size; i++) {
+			sines[i] = std::sin(2.0 * PI * i / size);
+			cosines[i] = std::cos(2.0 * PI * i / size);
+		}
+
+		for (unsigned i = 0; i < size; i++) {
+			harmonics.dc += samples[i];
+		}
+		harmonics.dc /= size;
+
+		for (unsigned harmonic = 1; harmonic <= count; harmonic++) {
+			double sineSum = 0.0, cosineSum = 0.0;
+			unsigned long long index = 0;
+			for (unsigned i = 0; i < size; i++) {
+				sineSum += samples[i] * sines[index];
+				cosineSum += samples[i] * cosines[index];
+				index = (index + harmonic) % size;
+			}
+			const double scale = (2 * harmonic == size) ? 1.0 / size : 2.0 / size;
+			harmonics.sines[harmonic] = sineSum * scale;
+			harmonics.cosines[harmonic] = cosineSum * scale;
+		}
+		return harmonics;
+	}
+
+	/// <summary>
+	/// Mip chain of a harmonic series: level l keeps the harmonics up to (size / 2) >> l
+	/// in getLevelSize(size, l) samples
+	/// </summary>
+	std::shared_ptr<const Oscillators::Wavetables::MipMap> synthesiseMipMap(const Harmonics& harmonics, const unsigned& size, const unsigned& firstLevel) {
+		auto mipMap = std::make_shared<Oscillators::Wavetables::MipMap>();
+		const unsigned numLevels = Oscillators::Wavetables::getNumLevels(size);
+		for (unsigned level = firstLevel; level < numLevels; level++) {
+			const unsigned levelSize = Oscillators::Wavetables::getLevelSize(size, level);
+			auto table = std::make_shared<std::vector<float>>(synthesise(harmonics, levelSize, (size / 2) >> level));
+			Oscillators::Wavetables::Table levelTable;
+			levelTable.samples = std::shared_ptr<const float>(table, table->data());
+			levelTable.size = levelSize;
+			mipMap->levels.push_back(levelTable);
+		}
+		return mipMap;
+	}
+
+	Harmonics fromAmplitudes(const std::vector<float>& amplitudes, const std::vector<float>& phases) {
+		Harmonics harmonics((unsigned)amplitudes.size());
+		for (unsigned i = 0; i < amplitudes.size(); i++) {
+			const double phase = (i < phases.size()) ? phases[i] : 0.0;
+			// a * sin(x + phase) = a * cos(phase) * sin(x) + a * sin(phase) * cos(x)
+			harmonics.sines[i + 1] = amplitudes[i] * std::cos(phase);
+			harmonics.cosines[i + 1] = amplitudes[i] * std::sin(phase);
+		}
+		return harmonics;
+	}
+};
+
+std::vector<float> Oscillators::Wavetables::bandLimitedTable(const Oscillators::Type& type, const unsigned& size, const unsigned& maxHarmonic) {
+	const unsigned count = (maxHarmonic < size / 2) ? maxHarmonic : size / 2;
+	Harmonics harmonics(count);
+	for (unsigned harmonic = 1; harmonic <= count; harmonic++) {
+		switch (type) {
+		case(Oscillators::Type::SAW):
+			harmonics.sines[harmonic] = -2.0 / (PI * harmonic);
+			break;
+		case(Oscillators::Type::SQUARE):
+			harmonics.sines[harmonic] = (harmonic % 2 == 1) ? -4.0 / (PI * harmonic) : 0.0;
+			break;
+		case(Oscillators::Type::TRIANGLE):
+			harmonics.cosines[harmonic] = (harmonic % 2 == 1) ? -8.0 / (PI * PI * harmonic * harmonic) : 0.0;
+			break;
+		default:
+			harmonics.sines[harmonic] = (harmonic == 1) ? 1.0 : 0.0;
+			break;
+		}
+	}
+	return synthesise(harmonics, size, count);
+}
+
+std::vector<float> Oscillators::Wavetables::fromHarmonics(const std::vector<float>& amplitudes, const std::vector<float>& phases, const unsigned& size) {
+	return synthesise(fromAmplitudes(amplitudes, phases), size, (unsigned)amplitudes.size());
+}
+
+std::shared_ptr<const Oscillators::Wavetables::MipMap> Oscillators::Wavetables::mipMapFromHarmonics(const std::vector<float>& amplitudes, const std::vector<float>& phases, const unsigned& size) {
+	return synthesiseMipMap(fromAmplitudes(amplitudes, phases), size, 0);
+}
+
+unsigned Oscillators::Wavetables::getNumLevels(const unsigned& size) {
+	unsigned levels = 1;
+	while (((size / 2) >> levels) >= 1) {
+		levels++;
+	}
+	return levels;
+}
+
+unsigned Oscillators::Wavetables::getLevel(const MipMap& mipMap, const float& delta) {
+	const float octave = (delta > 0.0f) ? std::log2(delta) : -1.0f;
+	const unsigned level = (octave > 0.0f) ? (unsigned)std::ceil(octave) : 0;
+	const unsigned numLevels = (unsigned)mipMap.levels.size();
+	return (level >= numLevels) ? numLevels - 1 : level;
+}
+
+namespace {
+	std::mutex tableMutex;
+	std::map<std::tuple<Oscillators::Type, unsigned, unsigned>, Oscillators::Wavetables::Table> tableCache;
+	std::mutex mipMapMutex;
+	std::map<std::pair<Oscillators::Type, unsigned>, std::shared_ptr<const Oscillators::Wavetables::MipMap>> mipMapCache;
+};
+
+Oscillators::Wavetables::Table Oscillators::Wavetables::getSharedWavetable(const Oscillators::Type& type, const unsigned& size, const unsigned& level) {
+	std::lock_guard<std::mutex> lock(tableMutex);
+	auto key = std::make_tuple(type, size, level);
+	auto found = tableCache.find(key);
+	if (found != tableCache.end()) {
+		return found->second;
+	}
+
+	unsigned maxHarmonic = (size / 2) >> level;
+	auto samples = std::make_shared<const std::vector<float>>(bandLimitedTable(type, size, (maxHarmonic > 0) ? maxHarmonic : 1));
+	Table table;
+	table.samples = std::shared_ptr<const float>(samples, samples->data());
+	table.size = (unsigned)samples->size();
+	tableCache[key] = table;
+	return table;
+}
+
+std::shared_ptr<const Oscillators::Wavetables::MipMap> Oscillators::Wavetables::getSharedMipMap(const Oscillators::Type& type, const unsigned& size) {
+	auto key = std::make_pair(type, size);
+	{
+		std::lock_guard<std::mutex> lock(mipMapMutex);
+		auto found = mipMapCache.find(key);
+		if (found != mipMapCache.end()) {
+			return found->second;
+		}
+	}
+
+	// Build outside the lock; if two threads race, the first one stored wins
+	auto mipMap = std::make_shared<MipMap>();
+	const unsigned numLevels = getNumLevels(size);
+	for (unsigned level = 0; level < numLevels; level++) {
+		mipMap->levels.push_back(getSharedWavetable(type, size, level));
+	}
+
+	std::lock_guard<std::mutex> lock(mipMapMutex);
+	auto inserted = mipMapCache.emplace(key, mipMap);
+	return inserted.first->second;
+}
+
+namespace {
+	// Smallest level of a loaded table
+	constexpr unsigned MIN_LEVEL_SIZE = 64;
+
+	// Cache file: CacheHeader, then every level of every frame in order as native floats
+	const char CACHE_MAGIC[4] = { 'L', 'K', 'M', 'C' };
+	constexpr uint32_t CACHE_VERSION = 1;
+
+	struct CacheHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t frameSize;
+		uint32_t numLevels;
+		uint32_t numFrames;
+		uint32_t reserved;
+		uint64_t sourceHash;
+	};
+
+	using MappedFile = std::shared_ptr<const juce::MemoryMappedFile>;
+
+	MappedFile mapFile(const std::string& path) {
+		auto file = std::make_shared<const juce::MemoryMappedFile>(juce::File(path), juce::MemoryMappedFile::readOnly);
+		return (file->getData() != nullptr) ? file : nullptr;
+	}
+
+	/// <summary>
+	/// Cache key of a source file, 8 bytes at a time so a large library hashes quickly
+	/// </summary>
+	uint64_t hashFile(const MappedFile& file, const unsigned& frameSize) {
+		const unsigned char* data = (const unsigned char*)file->getData();
+		const size_t size = file->getSize();
+		uint64_t hash = 14695981039346656037ull ^ ((uint64_t)size << 32) ^ frameSize;
+		size_t i = 0;
+		for (; i + 8 <= size; i += 8) {
+			uint64_t word;
+			std::memcpy(&word, data + i, 8);
+			hash = (hash ^ word) * 1099511628211ull;
+		}
+		for (; i < size; i++) {
+			hash = (hash ^ data[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	uint16_t readU16(const unsigned char* data) { return (uint16_t)(data[0] | (data[1] << 8)); }
+	uint32_t readU32(const unsigned char* data) { return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24); }
+
+	/// <summary>
+	/// First channel of a file as floats. Aliases the mapping when no conversion is needed.
+	/// </summary>
+	struct Decoded {
+		std::shared_ptr<const float> samples;
+		size_t count = 0;
+	};
+
+	Decoded decodeRaw(const MappedFile& file) {
+		Decoded decoded;
+		const float* samples = (const float*)file->getData();
+		decoded.samples = std::shared_ptr<const float>(file, samples);
+		decoded.count = file->getSize() / sizeof(float);
+		return decoded;
+	}
+
+	Decoded decodeWav(const MappedFile& file) {
+		Decoded decoded;
+		const unsigned char* data = (const unsigned char*)file->getData();
+		const size_t size = file->getSize();
+		if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+			return decoded;
+		}
+
+		uint16_t format = 0, channels = 0, bits = 0;
+		size_t offset = 12;
+		while (offset + 8 <= size) {
+			const uint32_t chunkSize = readU32(data + offset + 4);
+			const unsigned char* chunk = data + offset + 8;
+			const size_t available = ((size_t)chunkSize < size - offset - 8) ? (size_t)chunkSize : size - offset - 8;
+
+			if (std::memcmp(data + offset, "fmt ", 4) == 0 && available >= 16) {
+				format = readU16(chunk);
+				channels = readU16(chunk + 2);
+				bits = readU16(chunk + 14);
+				if (format == 0xFFFE && available >= 26) {
+					// WAVE_FORMAT_EXTENSIBLE: the sub-format GUID starts with the plain format tag
+					format = readU16(chunk + 24);
+				}
+			}
+			else if (std::memcmp(data + offset, "data", 4) == 0) {
+				const bool isFloat = (format == 3 && bits == 32);
+				const bool isPcm = (format == 1 && (bits == 16 || bits == 24));
+				if (channels == 0 || (!isFloat && !isPcm)) {
+					return decoded;
+				}
+
+				const size_t stride = (size_t)(bits / 8) * channels;
+				const size_t count = available / stride;
+				if (isFloat && channels == 1 && ((uintptr_t)chunk % alignof(float)) == 0) {
+					decoded.samples = std::shared_ptr<const float>(file, (const float*)chunk);
+					decoded.count = count;
+					return decoded;
+				}
+
+				auto converted = std::make_shared<std::vector<float>>(count);
+				for (size_t i = 0; i < count; i++) {
+					const unsigned char* sample = chunk + i * stride;
+					if (isFloat) {
+						std::memcpy(&(*converted)[i], sample, sizeof(float));
+					}
+					else if (bits == 16) {
+						(*converted)[i] = (float)(int16_t)readU16(sample) / 32768.0f;
+					}
+					else {
+						int32_t value = (int32_t)(((uint32_t)sample[0] << 8) | ((uint32_t)sample[1] << 16) | ((uint32_t)sample[2] << 24)) >> 8;
+						(*converted)[i] = (float)value / 8388608.0f;
+					}
+				}
+				decoded.samples = std::shared_ptr<const float>(converted, converted->data());
+				decoded.count = count;
+				return decoded;
+			}
+			offset += 8 + (size_t)chunkSize + (chunkSize & 1);
+		}
+		return decoded;
+	}
+
+	bool isWav(const std::string& path) {
+		if (path.size() < 4) {
+			return false;
+		}
+		std::string extension = path.substr(path.size() - 4);
+		for (auto& character : extension) {
+			character = (char)std::tolower((unsigned char)character);
+		}
+		return extension == ".wav";
+	}
+
+	/// <summary>
+	/// Mip chain of one frame: level 0 is the frame itself, each higher level is
+	/// resynthesised from the frame's spectrum with the harmonics it can hold
+	/// </summary>
+	std::shared_ptr<const Oscillators::Wavetables::MipMap> buildMipMap(const std::shared_ptr<const float>& frame, const unsigned& size) {
+		auto mipMap = std::make_shared<Oscillators::Wavetables::MipMap>();
+		Oscillators::Wavetables::Table level0;
+		level0.samples = frame;
+		level0.size = size;
+		mipMap->levels.push_back(level0);
+
+		const unsigned numLevels = Oscillators::Wavetables::getNumLevels(size);
+		if (numLevels < 2) {
+			return mipMap;
+		}
+
+		// Spectrum up to the highest harmonic level 1 keeps
+		const Harmonics harmonics = analyse(frame.get(), size, (size / 2) >> 1);
+		const auto levels = synthesiseMipMap(harmonics, size, 1);
+		mipMap->levels.insert(mipMap->levels.end(), levels->levels.begin(), levels->levels.end());
+		return mipMap;
+	}
+
+	Oscillators::Wavetables::Frames loadFrames(const MappedFile& file, const std::string& path, const unsigned& frameSize) {
+		Oscillators::Wavetables::Frames frames;
+		const Decoded decoded = isWav(path) ? decodeWav(file) : decodeRaw(file);
+		if (decoded.count == 0 || frameSize == 0) {
+			return frames;
+		}
+
+		const unsigned size = (decoded.count < frameSize) ? (unsigned)decoded.count : frameSize;
+		const size_t numFrames = decoded.count / size;
+		for (size_t frame = 0; frame < numFrames; frame++) {
+			frames.push_back(buildMipMap(std::shared_ptr<const float>(decoded.samples, decoded.samples.get() + frame * size), size));
+		}
+		return frames;
+	}
+
+	Oscillators::Wavetables::Frames readCache(const std::string& cachePath, const uint64_t& sourceHash) {
+		Oscillators::Wavetables::Frames frames;
+		auto file = mapFile(cachePath);
+		if (!file || file->getSize() < sizeof(CacheHeader)) {
+			return frames;
+		}
+
+		CacheHeader header;
+		std::memcpy(&header, file->getData(), sizeof(CacheHeader));
+		if (std::memcmp(header.magic, CACHE_MAGIC, 4) != 0 || header.version != CACHE_VERSION || header.sourceHash != sourceHash
+			|| header.frameSize == 0 || header.numLevels != Oscillators::Wavetables::getNumLevels(header.frameSize)) {
+			return frames;
+		}
+
+		size_t floatsPerFrame = 0;
+		for (unsigned level = 0; level < header.numLevels; level++) {
+			floatsPerFrame += Oscillators::Wavetables::getLevelSize(header.frameSize, level);
+		}
+		if (sizeof(CacheHeader) + (size_t)header.numFrames * floatsPerFrame * sizeof(float) > file->getSize()) {
+			return frames;
+		}
+
+		// Every level points into the mapping
+		const float* samples = (const float*)((const char*)file->getData() + sizeof(CacheHeader));
+		for (unsigned frame = 0; frame < header.numFrames; frame++) {
+			auto mipMap = std::make_shared<Oscillators::Wavetables::MipMap>();
+			for (unsigned level = 0; level < header.numLevels; level++) {
+				Oscillators::Wavetables::Table table;
+				table.samples = std::shared_ptr<const float>(file, samples);
+				table.size = Oscillators::Wavetables::getLevelSize(header.frameSize, level);
+				mipMap->levels.push_back(table);
+				samples += table.size;
+			}
+			frames.push_back(mipMap);
+		}
+		return frames;
+	}
+
+	/// <summary>
+	/// Move a file over another in one step, so readers see either the old or the new one
+	/// </summary>
+	bool replaceFile(const std::string& source, const std::string& destination) {
+#if defined(_WIN32)
+		return MoveFileExA(source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		// POSIX rename replaces an existing destination atomically
+		return std::rename(source.c_str(), destination.c_str()) == 0;
+#endif
+	}
+
+	void writeCache(const std::string& cachePath, const Oscillators::Wavetables::Frames& frames, const uint64_t& sourceHash) {
+		if (frames.empty()) {
+			return;
+		}
+
+		CacheHeader header{};
+		std::memcpy(header.magic, CACHE_MAGIC, 4);
+		header.version = CACHE_VERSION;
+		header.frameSize = frames[0]->levels[0].size;
+		header.numLevels = (uint32_t)frames[0]->levels.size();
+		header.numFrames = (uint32_t)frames.size();
+		header.sourceHash = sourceHash;
+
+		// Write next to the cache and rename, so a crash never leaves a torn cache behind
+		const std::string temporaryPath = cachePath + ".tmp";
+		{
+			std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+			stream.write((const char*)&header, sizeof(CacheHeader));
+			for (const auto& mipMap : frames) {
+				for (const auto& level : mipMap->levels) {
+					stream.write((const char*)level.samples.get(), (std::streamsize)(level.size * sizeof(float)));
+				}
+			}
+			if (!stream.good()) {
+				stream.close();
+				std::remove(temporaryPath.c_str());
+				return;
+			}
+		}
+		if (!replaceFile(temporaryPath, cachePath)) {
+			std::remove(temporaryPath.c_str());
+		}
+	}
+};
+
+unsigned Oscillators::Wavetables::getLevelSize(const unsigned& size, const unsigned& level) {
+	const unsigned smallest = (size < MIN_LEVEL_SIZE) ? size : MIN_LEVEL_SIZE;
+	const unsigned levelSize = size >> level;
+	return (levelSize > smallest) ? levelSize : smallest;
+}
+
+Oscillators::Wavetables::Frames Oscillators::Wavetables::loadWavetableFile(const std::string& path, const unsigned& frameSize) {
+	auto file = mapFile(path);
+	if (!file) {
+		return Frames();
+	}
+	return loadFrames(file, path, frameSize);
+}
+
+Oscillators::Wavetables::Frames Oscillators::Wavetables::loadCachedWavetableFile(const std::string& path, const std::string& cachePath, const unsigned& frameSize) {
+	auto file = mapFile(path);
+	if (!file) {
+		return Frames();
+	}
+
+	const uint64_t sourceHash = hashFile(file, frameSize);
+	Frames frames = readCache(cachePath, sourceHash);
+	if (!frames.empty()) {
+		return frames;
+	}
+
+	frames = loadFrames(file, path, frameSize);
+	writeCache(cachePath, frames, sourceHash);
+	return frames;
 }
\ No newline at end of file
@@ -1,15 +1,129 @@
 #ifndef LOTKEY_CPP_JUCE_WAVETABLES_H
 #define LOTKEY_CPP_JUCE_WAVETABLES_H
 
+#include <memory>
+#include <string>
 #include <vector>
 #include "Oscillators.h"
 
 namespace Oscillators::Wavetables {
+	/// <summary>
+	/// Immutable handle to a wavetable shared between voices.
+	/// Copying a Table only copies the pointer.
+	/// </summary>
+	struct Table {
+		std::shared_ptr<const float> samples;
+		unsigned size = 0;
+	};
+
+	/// <summary>
+	/// Band-limited mip chain with one table per octave.
+	/// Level l keeps harmonics up to (size / 2) >> l, so it is alias-free while the
+	/// table is read at most 2^l samples per output sample.
+	/// Levels may be smaller than level 0 (see getLevelSize); a level is read at the
+	/// level 0 position scaled by levels[l].size / levels[0].size.
+	/// </summary>
+	struct MipMap {
+		std::vector<Table> levels;
+	};
+
+	/// <summary>
+	/// Frames of a wavetable file, each band-limited into its own mip chain
+	/// </summary>
+	using Frames = std::vector<std::shared_ptr<const MipMap>>;
+
 	std::vector<float> sawTable(const unsigned& size);
 	std::vector<float> sineTable(const unsigned& size);
 	std::vector<float> squareTable(const unsigned& size);
 	std::vector<float> triangleTable(const unsigned& size);
 	std::vector<float> getWavetable(const Oscillators::Type& type, const unsigned& size);
+	/// <summary>
+	/// Build one cycle of a shape by summing its harmonics up to maxHarmonic
+	/// </summary>
+	/// <param name="type"> - shape of the table </param>
+	/// <param name="size"> - number of samples in the table </param>
+	/// <param name="maxHarmonic"> - highest harmonic to include </param>
+	/// <returns> band-limited table </returns>
+	std::vector<float> bandLimitedTable(const Oscillators::Type& type, const unsigned& size, const unsigned& maxHarmonic);
+	/// <summary>
+	/// Build one cycle from a harmonic spectrum: sample t (in cycles) is the sum of
+	/// amplitudes[h - 1] * sin(2 pi h t + phases[h - 1]). Harmonics above size / 2 are dropped.
+	/// O(N log N) by inverse FFT when size is a power of two, O(N * harmonics) otherwise.
+	/// </summary>
+	/// <param name="amplitudes"> - amplitude of each harmonic, from the fundamental up </param>
+	/// <param name="phases"> - phase (radians) of each harmonic; missing entries are 0 </param>
+	/// <param name="size"> - number of samples in the table </param>
+	/// <returns> band-limited table </returns>
+	std::vector<float> fromHarmonics(const std::vector<float>& amplitudes, const std::vector<float>& phases, const unsigned& size);
+	/// <summary>
+	/// Build a mip chain from a harmonic spectrum, see fromHarmonics. Level l keeps the
+	/// harmonics up to (size / 2) >> l in getLevelSize(size, l) samples. Call off the audio thread.
+	/// </summary>
+	/// <param name="amplitudes"> - amplitude of each harmonic, from the fundamental up </param>
+	/// <param name="phases"> - phase (radians) of each harmonic; missing entries are 0 </param>
+	/// <param name="size"> - number of samples in level 0 </param>
+	/// <returns> immutable mip chain, ready for Wavetable::setMipMap </returns>
+	std::shared_ptr<const MipMap> mipMapFromHarmonics(const std::vector<float>& amplitudes, const std::vector<float>& phases, const unsigned& size);
+	/// <summary>
+	/// Get the number of mip levels for a table size
+	/// </summary>
+	/// <param name="size"> - number of samples in the table </param>
+	unsigned getNumLevels(const unsigned& size);
+	/// <summary>
+	/// Get the mip level to read at a speed. Level l is alias-free while the
+	/// table is read at most 2^l level 0 samples per output sample.
+	/// </summary>
+	/// <param name="mipMap"> - chain to read, with at least one level </param>
+	/// <param name="delta"> - level 0 samples advanced per output sample </param>
+	unsigned getLevel(const MipMap& mipMap, const float& delta);
+	/// <summary>
+	/// Get the process-wide shared copy of a band-limited wavetable, building it on first use.
+	/// Safe to call from any thread, but it may lock and allocate, so call it off the audio thread.
+	/// </summary>
+	/// <param name="type"> - shape of the table </param>
+	/// <param name="size"> - number of samples in the table </param>
+	/// <param name="level"> - mip level, 0 keeps every harmonic the table can hold </param>
+	/// <returns> shared immutable table </returns>
+	Table getSharedWavetable(const Oscillators::Type& type, const unsigned& size, const unsigned& level = 0);
+	/// <summary>
+	/// Get the process-wide shared mip chain of a shape, building it on first use.
+	/// Safe to call from any thread, but it may lock and allocate, so call it off the audio thread.
+	/// </summary>
+	/// <param name="type"> - shape of the table </param>
+	/// <param name="size"> - number of samples in each level </param>
+	/// <returns> shared immutable mip chain </returns>
+	std::shared_ptr<const MipMap> getSharedMipMap(const Oscillators::Type& type, const unsigned& size);
+	/// <summary>
+	/// Get the size of a mip level of a loaded table. Each level halves the size, keeping
+	/// the same samples per harmonic as level 0, down to 64 samples.
+	/// </summary>
+	/// <param name="size"> - number of samples in level 0 </param>
+	/// <param name="level"> - mip level </param>
+	unsigned getLevelSize(const unsigned& size, const unsigned& level);
+	/// <summary>
+	/// Load a single-cycle or multi-frame wavetable file.
+	/// .wav files may be 32-bit float or 16/24-bit PCM (first channel is used); any
+	/// other extension is read as raw native-endian 32-bit floats.
+	/// The file is memory-mapped and level 0 of each frame points straight into the
+	/// mapping when the samples are mono 32-bit float, so nothing is copied.
+	/// Higher levels are computed, which is slow for large libraries: see loadCachedWavetableFile.
+	/// Call off the audio thread.
+	/// </summary>
+	/// <param name="path"> - absolute path of the file </param>
+	/// <param name="frameSize"> - samples per frame; a file shorter than this is one frame </param>
+	/// <returns> one mip chain per frame, empty if the file could not be read </returns>
+	Frames loadWavetableFile(const std::string& path, const unsigned& frameSize = WAVETABLE_SIZE);
+	/// <summary>
+	/// Load a wavetable file through an on-disk mip cache.
+	/// If cachePath holds the mip levels of this exact file (checked by content hash) they are
+	/// memory-mapped with no copy and no computation. Otherwise the file is loaded with
+	/// loadWavetableFile and the cache is (re)written. Call off the audio thread.
+	/// </summary>
+	/// <param name="path"> - absolute path of the file </param>
+	/// <param name="cachePath"> - absolute path of its cache file </param>
+	/// <param name="frameSize"> - samples per frame; a file shorter than this is one frame </param>
+	/// <returns> one mip chain per frame, empty if the file could not be read </returns>
+	Frames loadCachedWavetableFile(const std::string& path, const std::string& cachePath, const unsigned& frameSize = WAVETABLE_SIZE);
 };
 
 #endif
\ No newline at end of file